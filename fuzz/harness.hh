@@ -0,0 +1,80 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_FUZZ_HARNESS_HH
+#define CYRA_FUZZ_HARNESS_HH
+
+#include <cyra/argument.hh>
+#include <cyra/commandline.hh>
+#include <cyra/exception.hh>
+#include <cyra/lexer.hh>
+#include <cyra/parser.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*  Shared by the libFuzzer targets next to this file, each turning its
+    input into a commandline and handing it to exercise. Inputs are bounded
+    by limits as untrusted input would be, so that a slow input points at
+    the parser, not at its size. Only parsing errors are expected.
+*/
+
+namespace cyra::fuzz {
+
+template<typename Lexer>
+void parse(commandline line)
+{
+    flag all{"-a", "--all"}, brief{"-b"};
+    value<std::string> name{{"-n", "--name"}, 0, 4};
+    value<int> level{{"-l", "--level"}, 0, 4};
+    operand<std::string> files{0, 8};
+    command remote{"remote"};
+    
+    remote.emplace<flag>("-f");
+    attach(line, all, brief, name, level, files, remote);
+    
+    limits bounds;
+    bounds.tokens=256;
+    bounds.length=1<<16;
+    bounds.bytes=1<<18;
+    
+    Lexer style;
+    parser core{style};
+    core.abbreviate(true);
+    core.restrict(bounds);
+    
+    try {
+        core(line);
+    } catch (const parsing_error&) {
+    }
+}
+
+inline void exercise(const commandline& line)
+{
+    parse<posix>(line);
+    parse<gnu>(line);
+}
+
+inline std::string text(const std::uint8_t* data, std::size_t size)
+{
+    return {reinterpret_cast<const char*>(data), size};
+}
+
+}
+
+#endif
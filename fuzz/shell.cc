@@ -0,0 +1,30 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "harness.hh"
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+    std::size_t size)
+{
+    try {
+        cyra::fuzz::exercise({cyra::fuzz::text(data, size), cyra::shell{}});
+    } catch (const cyra::parsing_error&) { // unterminated quotes
+    } catch (const cyra::initialization_error&) { // not even a path
+    }
+    
+    return 0;
+}
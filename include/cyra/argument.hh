@@ -21,6 +21,7 @@
 #include <cyra/container.hh>
 
 #include <cstddef>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <optional>
@@ -35,6 +36,14 @@ public:
         command, option, operand
     };
     
+    enum class origin {
+        none, // neither set nor defaulted
+        commandline,
+        environment,
+        configuration,
+        fallback // the default of a value
+    };
+    
     class qualifier {
     public:
         virtual ~qualifier()=default;
@@ -51,6 +60,8 @@ public:
         const std::optional<std::string>& standard() const noexcept;
         const std::optional<std::string>& current() const noexcept;
         
+        const std::vector<std::string>& keys() const noexcept;
+        
         bool query(const std::string& key) const;
         bool match(const std::string& key); // set current on success
         
@@ -99,7 +110,14 @@ public:
     virtual ~argument()=default;
     
     explicit operator bool() const noexcept;
-    bool set() const noexcept;
+    bool set() const noexcept; // supplied on the command line
+    
+    virtual bool defaulted() const noexcept; // not set, but has a default
+    
+    origin provenance() const noexcept; // where the value came from
+    void provenance(origin source) noexcept; // for values not on the line
+    
+    virtual void reset(); // forget the outcome of a parse, keep the schema
     
     category type() const noexcept;
     
@@ -115,6 +133,8 @@ private:
     
     std::unique_ptr<qualifier> m_name;
     std::unique_ptr<quantifier> m_count;
+    
+    origin m_origin{origin::none}; // recorded unless from the command line
 };
 
 class command: public argument, public range {
@@ -130,6 +150,16 @@ public:
     using argument::operator bool;
     
     qualifier& name() const;
+    
+    template<typename Type, typename... Arguments>
+    Type& emplace(Arguments&&... arguments); // construct, own and attach
+    
+    void defer(std::function<void(command&)> factory); // run on first entry
+    void populate(); // run the deferred factory, if any
+    
+private:
+    std::function<void(command&)> m_factory;
+    std::vector<std::unique_ptr<argument>> m_arguments;
 };
 
 class option: public argument {
@@ -153,6 +183,12 @@ public:
     option(qualifier name, std::size_t minimum, std::size_t maximum);
     
     qualifier& name() const;
+    
+    option& bind(std::string variable); // fall back to the environment
+    const std::optional<std::string>& variable() const noexcept;
+    
+private:
+    std::optional<std::string> m_variable;
 };
 
 class flag: public option {
@@ -163,8 +199,21 @@ public:
 template<typename Type>
 class value: public option, public list<Type> {
 public:
+    using element_type=element_t<Type>; // tags such as lazy unwrapped
+    
     using option::option;
     using option::operator bool;
+    
+    value& fallback(element_type standard); // stored as is, never cast
+    
+    element_type get() const; // the last element supplied, or the default
+    
+    virtual bool defaulted() const noexcept override;
+    
+    virtual void reset() override;
+    
+private:
+    std::optional<element_type> m_fallback;
 };
 
 template<typename Type>
@@ -179,6 +228,8 @@ public:
     operand(std::size_t minimum, std::size_t maximum);
     
     using argument::operator bool;
+    
+    virtual void reset() override;
 };
 
 }
@@ -22,6 +22,7 @@
 #   error argument.tcc is intended for internal use only
 #endif
 
+#include <stdexcept>
 #include <utility>
 
 namespace cyra {
@@ -29,12 +30,24 @@ namespace cyra {
 template<typename String, typename... Strings>
 command::command(String&& key, Strings&&... keys)
     : argument{category::command,
-        std::make_unique<qualifier>(qualifier{std::forward<String>(key),
-            std::forward<Strings>(keys)...}),
+        std::make_unique<qualifier>(std::initializer_list<std::string>{
+            std::forward<String>(key), std::forward<Strings>(keys)...}),
         std::make_unique<quantifier>(0, 1)}
 {
 }
 
+template<typename Type, typename... Arguments>
+Type& command::emplace(Arguments&&... arguments)
+{
+    auto object=std::make_unique<Type>(std::forward<Arguments>(arguments)...);
+    auto& result=*object;
+    
+    m_arguments.push_back(std::move(object));
+    attach(result);
+    
+    return result;
+}
+
 template<typename String, typename... Strings>
 option::option(String&& key, Strings&&... keys)
     : option{{std::forward<String>(key), std::forward<Strings>(keys)...},
@@ -42,6 +55,47 @@ option::option(String&& key, Strings&&... keys)
 {
 }
 
+template<typename Type>
+value<Type>& value<Type>::fallback(element_type standard)
+{
+    static_assert(element<Type>::sequence,
+        "a mapping has no last element to fall back on");
+    
+    m_fallback=std::move(standard);
+    
+    return *this;
+}
+
+template<typename Type>
+auto value<Type>::get() const -> element_type
+{
+    static_assert(element<Type>::sequence,
+        "a mapping has no last element, use find or at instead");
+    
+    if (!list<Type>::empty()) {
+        return element_type{list<Type>::back()}; // no proxy, for bool
+    }
+    
+    if (!m_fallback) {
+        throw std::out_of_range{"value neither supplied nor defaulted"};
+    }
+    
+    return *m_fallback;
+}
+
+template<typename Type>
+bool value<Type>::defaulted() const noexcept
+{
+    return !set() && m_fallback.has_value();
+}
+
+template<typename Type>
+void value<Type>::reset()
+{
+    option::reset();
+    list<Type>::clear();
+}
+
 template<typename Type>
 operand<Type>::operand(std::size_t minimum)
     : operand{minimum, (minimum==0) ? size_t{1} : minimum}
@@ -61,6 +115,13 @@ operand<Type>::operand(std::size_t minimum, std::size_t maximum)
 {
 }
 
+template<typename Type>
+void operand<Type>::reset()
+{
+    argument::reset();
+    list<Type>::clear();
+}
+
 }
 
 #endif
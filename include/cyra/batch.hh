@@ -0,0 +1,106 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_BATCH_HH
+#define CYRA_BATCH_HH
+
+#include <cyra/commandline.hh>
+#include <cyra/pool.hh>
+
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cyra {
+
+class range;
+
+template<typename Type>
+class result { // outcome of one parse, a value or the exception it threw
+public:
+    result()=default; // neither, for inputs not yet parsed
+    result(Type value);
+    result(std::exception_ptr error) noexcept;
+    
+    explicit operator bool() const noexcept;
+    bool good() const noexcept;
+    
+    const Type& value() const; // rethrow the error, if any
+    std::exception_ptr error() const noexcept;
+    
+private:
+    std::optional<Type> m_value;
+    std::exception_ptr m_error;
+};
+
+template<>
+class result<void> { // outcome of one parse extracting nothing
+public:
+    result()=default; // neither, for inputs not yet parsed
+    result(std::in_place_t) noexcept; // succeeded
+    result(std::exception_ptr error) noexcept;
+    
+    explicit operator bool() const noexcept;
+    bool good() const noexcept;
+    
+    void value() const; // rethrow the error, if any
+    std::exception_ptr error() const noexcept;
+    
+private:
+    bool m_good{false};
+    std::exception_ptr m_error;
+};
+
+void reset(range& scope); // every argument, including nested commands
+
+/*  Parse each input, a container of arguments including the path, with one
+    State per worker, default constructed on first use. For every input a
+    commandline is built and passed to the state, which attaches its
+    arguments, parses and returns what it extracted:
+    
+    struct job {
+        value<int> level{{"-l", "--level"}, 1, 1};
+        
+        int operator()(commandline& line) {
+            attach(line, level);
+            parse<gnu>(line);
+            
+            return level.get();
+        }
+    };
+    
+    auto results=batch<job>(workers, inputs.begin(), inputs.end());
+    
+    The arguments are reset afterwards, so that a state is reused across
+    inputs, and each commandline recycles the index of the previous one
+    parsed by the same worker. Results are in input order; for a state
+    returning void they only tell success from the exception thrown. The
+    iterators have to be random access, as inputs are taken by index from
+    any worker.
+*/
+
+template<typename State, typename Iterator>
+auto batch(pool& workers, Iterator first, Iterator last)
+    -> std::vector<result<std::invoke_result_t<State&, commandline&>>>;
+
+}
+
+#include "batch.tcc"
+
+#endif
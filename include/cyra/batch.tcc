@@ -0,0 +1,124 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_BATCH_TCC
+#define CYRA_BATCH_TCC
+
+#ifndef CYRA_BATCH_HH
+#   error batch.tcc is intended for internal use only
+#endif
+
+#include <iterator>
+#include <utility>
+
+namespace cyra {
+
+template<typename Type>
+result<Type>::result(Type value)
+    : m_value{std::move(value)}
+{
+}
+
+template<typename Type>
+result<Type>::result(std::exception_ptr error) noexcept
+    : m_error{std::move(error)}
+{
+}
+
+template<typename Type>
+result<Type>::operator bool() const noexcept
+{
+    return good();
+}
+
+template<typename Type>
+bool result<Type>::good() const noexcept
+{
+    return m_value.has_value();
+}
+
+template<typename Type>
+const Type& result<Type>::value() const
+{
+    if (m_error) {
+        std::rethrow_exception(m_error);
+    }
+    
+    return m_value.value();
+}
+
+template<typename Type>
+std::exception_ptr result<Type>::error() const noexcept
+{
+    return m_error;
+}
+
+template<typename State, typename Iterator>
+auto batch(pool& workers, Iterator first, Iterator last)
+    -> std::vector<result<std::invoke_result_t<State&, commandline&>>>
+{
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+        typename std::iterator_traits<Iterator>::iterator_category>,
+        "batch requires random access iterators");
+    
+    using type=std::invoke_result_t<State&, commandline&>;
+    
+    const auto count=static_cast<std::size_t>(last-first);
+    
+    std::vector<result<type>> results(count);
+    std::vector<std::optional<State>> states(workers.size());
+    std::vector<std::optional<commandline>> lines(workers.size()); // last
+    
+    workers.run(count, [&](std::size_t index, std::size_t worker) {
+        auto& state=states[worker];
+        
+        if (!state) {
+            state.emplace();
+        }
+        
+        try {
+            commandline line{first[index]};
+            
+            if (auto& previous=lines[worker]; previous) {
+                line.recycle(*previous); // the same arguments, usually
+            }
+            
+            try {
+                if constexpr (std::is_void_v<type>) {
+                    state.value()(line);
+                    results[index]=result<type>{std::in_place};
+                } else {
+                    results[index]=result<type>{state.value()(line)};
+                }
+            } catch (...) {
+                reset(line);
+                throw;
+            }
+            
+            reset(line);
+            lines[worker].emplace(std::move(line));
+        } catch (...) {
+            results[index]=result<type>{std::current_exception()};
+        }
+    });
+    
+    return results;
+}
+
+}
+
+#endif
@@ -0,0 +1,48 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_BINARY_HH
+#define CYRA_BINARY_HH
+
+#include <cyra/cast.hh>
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace cyra {
+
+enum class encoding {
+    hexadecimal, // the default, or @hex:..., with an optional 0x
+    base64 // @b64:..., padded or not
+};
+
+// validate and decode in one pass; the position of an invalid character
+// counts from the start of the value
+
+cast_result decode(std::string_view value, encoding type,
+    std::vector<std::byte>& result);
+
+template<>
+struct caster<std::vector<std::byte>> { // dispatch on the prefix
+    static cast_result apply(std::string_view value,
+        std::vector<std::byte>& result);
+};
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_CACHE_HH
+#define CYRA_CACHE_HH
+
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace cyra {
+
+class argument;
+class range;
+
+/*  Bounded cache of parse results, least recently used first out. Results
+    are keyed by the arguments of a command line together with the
+    fingerprint of the schema of its root range and the settings of the
+    parser, and restore counts and values without lexing or casting. The
+    schemas of the nested commands a result enters are checked on restore,
+    so that commands never given are neither indexed nor populated.
+    With a cache attached, every parse starts from reset arguments, whether
+    it is restored or not. Parses depending on the environment or on a
+    configuration are not cached, and neither are those storing into trays
+    that cannot take a snapshot.
+    
+    A cache is not synchronized; parsers on several threads, e.g. within a
+    batch, need one cache each.
+*/
+
+class cache {
+    friend class parser;
+    
+public:
+    explicit cache(std::size_t capacity);
+    
+    std::size_t capacity() const noexcept;
+    std::size_t size() const noexcept;
+    
+    std::size_t hits() const noexcept;
+    std::size_t misses() const noexcept;
+    
+    void clear(); // drop all results, keep the counters
+    
+private:
+    struct state { // per argument, in the order of a walk from the root
+        const std::type_info* type;
+        std::size_t count;
+        std::any values; // tray snapshot, empty if the argument is not set
+    };
+    
+    struct entry {
+        std::string key;
+        std::vector<state> states;
+        std::vector<std::uint64_t> schemas; // of the commands entered
+    };
+    
+    std::size_t m_capacity;
+    
+    std::size_t m_hits{0};
+    std::size_t m_misses{0};
+    
+    std::list<entry> m_entries; // most recently used first
+    std::unordered_map<std::string_view,
+        std::list<entry>::iterator> m_index; // viewing the entry keys
+    
+    bool restore(const std::string& key, range& root); // a hit or a miss
+    void store(std::string key, const range& root);
+    
+    static bool capture(const range& scope, entry& output);
+    
+    // check the states against the schemas, or write them
+    static bool apply(range& scope, const entry& source,
+        std::size_t& position, std::size_t& command, bool write);
+};
+
+}
+
+#endif
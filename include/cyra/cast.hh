@@ -19,15 +19,74 @@
 #define CYRA_CAST_HH
 
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace cyra {
 
+struct cast_result {
+    enum class outcome {
+        success,
+        invalid, // not a representation of the type
+        underflow, // below the range of the type
+        overflow, // above the range of the type
+        range // beyond any representable range
+    };
+    
+    outcome status{outcome::success};
+    const char* type{""}; // description for messages, e.g. "an integer"
+    
+    std::size_t position{std::string::npos}; // of an invalid character
+    
+    explicit operator bool() const noexcept; // successful
+    
+    void check(std::string_view value) const; // throw matching cast_error
+};
+
+cast_result convert(std::string_view value, bool& result);
+cast_result convert(std::string_view value, char& result);
+
+cast_result convert(std::string_view value, short& result);
+cast_result convert(std::string_view value, unsigned short& result);
+cast_result convert(std::string_view value, int& result);
+cast_result convert(std::string_view value, unsigned int& result);
+cast_result convert(std::string_view value, long& result);
+cast_result convert(std::string_view value, unsigned long& result);
+cast_result convert(std::string_view value, long long& result);
+cast_result convert(std::string_view value, unsigned long long& result);
+
+cast_result convert(std::string_view value, float& result);
+cast_result convert(std::string_view value, double& result);
+cast_result convert(std::string_view value, long double& result);
+
+cast_result convert(std::string_view value, std::string& result);
+
+template<typename Type, typename=void>
+struct caster { // specialize, or declare convert() next to the type
+    static constexpr bool generic{true};
+    
+    static cast_result apply(std::string_view value, Type& result);
+};
+
 template<typename Type>
+Type cast(std::string_view value); // throw on failure
+
+template<typename Type> // specializations of this form keep working
 Type cast(const std::string& value);
 
+template<typename Type>
+Type cast(const char* value);
+
 template<typename Type>
 std::string cast(const Type& value);
 
+// split on the delimiter and append each element; only the delimiters are
+// found with SIMD, the elements are parsed eight digits at a time at most
+template<typename Type>
+void cast(const std::string& value, char delimiter, std::vector<Type>& output);
+
 }
 
 #include "cast.tcc"
@@ -24,6 +24,57 @@
 
 namespace cyra {
 
+template<typename Type, typename=void>
+struct convertible: std::false_type {};
+
+template<typename Type> // found here or by argument lookup
+struct convertible<Type, std::void_t<decltype(convert(
+    std::declval<std::string_view>(), std::declval<Type&>()))>>:
+    std::true_type {};
+
+template<typename Type, typename=void>
+struct specialized: std::true_type {};
+
+template<typename Type>
+struct specialized<Type, std::enable_if_t<caster<Type>::generic>>:
+    std::false_type {};
+
+template<typename Type, typename Enable>
+cast_result caster<Type, Enable>::apply(std::string_view value, Type& result)
+{
+    if constexpr (convertible<Type>::value) {
+        return convert(value, result);
+    } else {
+        result=cast<Type>(std::string{value}); // specialized by the user
+        
+        return {};
+    }
+}
+
+template<typename Type>
+Type cast(std::string_view value)
+{
+    Type result{};
+    caster<Type>::apply(value, result).check(value);
+    
+    return result;
+}
+
+template<typename Type>
+Type cast(const std::string& value)
+{
+    static_assert(convertible<Type>::value || specialized<Type>::value,
+        "declare convert() for the type, or specialize caster or cast");
+    
+    return cast<Type>(std::string_view{value});
+}
+
+template<typename Type>
+Type cast(const char* value)
+{
+    return cast<Type>(std::string_view{value});
+}
+
 template<typename Type>
 std::string cast(const Type& value)
 {
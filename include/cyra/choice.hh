@@ -0,0 +1,83 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_CHOICE_HH
+#define CYRA_CHOICE_HH
+
+#include <cyra/cast.hh>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace cyra {
+
+template<typename Enum, std::size_t Size>
+class choice { // spellings of an enumeration behind a perfect hash
+public:
+    using entry=std::pair<std::string_view, Enum>;
+    
+    constexpr explicit choice(const entry (&entries)[Size]);
+    
+    constexpr std::size_t size() const noexcept;
+    
+    constexpr std::optional<Enum> find(std::string_view key) const; // O(1)
+    constexpr std::string_view spelling(Enum value) const; // linear
+    
+    std::string describe() const; // "one of fast, safe or paranoid"
+    
+private:
+    static constexpr std::size_t buckets{Size ? Size : 1};
+    static constexpr std::size_t slots{[] {
+        std::size_t count{1};
+        
+        while (count<Size) {
+            count*=2;
+        }
+        
+        return count;
+    }()};
+    
+    static constexpr std::uint64_t hash(std::string_view key);
+    static constexpr std::size_t slot(std::uint64_t hash, std::uint32_t seed);
+    
+    std::array<entry, Size> m_entries{};
+    std::array<std::uint32_t, buckets> m_seeds{}; // displacement per bucket
+    std::array<std::size_t, slots> m_slots{}; // entry index, Size if empty
+};
+
+template<typename Enum, std::size_t Size>
+constexpr auto spell(const std::pair<std::string_view, Enum> (&entries)[Size]);
+
+template<typename Enum>
+struct choices; // specialize with a static constexpr member table=spell(...)
+
+template<typename Enum>
+struct caster<Enum, std::void_t<decltype(choices<Enum>::table)>> {
+    static cast_result apply(std::string_view value, Enum& result);
+};
+
+}
+
+#include "choice.tcc"
+
+#endif
@@ -0,0 +1,201 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_CHOICE_TCC
+#define CYRA_CHOICE_TCC
+
+#ifndef CYRA_CHOICE_HH
+#   error choice.tcc is intended for internal use only
+#endif
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace cyra {
+
+template<typename Enum, std::size_t Size>
+constexpr choice<Enum, Size>::choice(const entry (&entries)[Size])
+{
+    std::array<std::uint64_t, Size> hashes{};
+    std::array<std::size_t, Size> members{}; // entry indices by bucket
+    std::array<std::size_t, buckets+1> starts{};
+    
+    std::size_t largest{0};
+    
+    for (std::size_t index{0}; index<Size; ++index) {
+        m_entries[index].first=entries[index].first;
+        m_entries[index].second=entries[index].second;
+        
+        hashes[index]=hash(entries[index].first);
+        ++starts[hashes[index]%buckets+1];
+    }
+    
+    for (std::size_t bucket{0}; bucket<buckets; ++bucket) {
+        largest=std::max(largest, starts[bucket+1]);
+        starts[bucket+1]+=starts[bucket];
+    }
+    
+    for (std::size_t index{0}, filled[buckets]{}; index<Size; ++index) {
+        const auto bucket=hashes[index]%buckets;
+        members[starts[bucket]+filled[bucket]++]=index;
+    }
+    
+    for (auto& entry:m_slots) {
+        entry=Size;
+    }
+    
+    // find a seed per bucket that moves all its keys into free slots,
+    // filling the crowded buckets while most slots are still free
+    
+    for (auto size=largest; size>0; --size) {
+        for (std::size_t bucket{0}; bucket<buckets; ++bucket) {
+            const auto first=starts[bucket], last=starts[bucket+1];
+            
+            if (last-first!=size) {
+                continue;
+            }
+            
+            for (auto index=first; index<last; ++index) {
+                for (auto other=first; other<index; ++other) {
+                    if (m_entries[members[index]].first==
+                        m_entries[members[other]].first) {
+                        throw std::logic_error{"duplicate choice spelling"};
+                    }
+                }
+            }
+            
+            for (std::uint32_t seed{0};; ++seed) {
+                bool free{true};
+                
+                for (auto index=first; free && index<last; ++index) {
+                    const auto position=slot(hashes[members[index]], seed);
+                    free=m_slots[position]==Size;
+                    
+                    for (auto other=first; free && other<index; ++other) {
+                        free=slot(hashes[members[other]], seed)!=position;
+                    }
+                }
+                
+                if (free) {
+                    for (auto index=first; index<last; ++index) {
+                        m_slots[slot(hashes[members[index]], seed)]=
+                            members[index];
+                    }
+                    
+                    m_seeds[bucket]=seed;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+template<typename Enum, std::size_t Size>
+constexpr std::size_t choice<Enum, Size>::size() const noexcept
+{
+    return Size;
+}
+
+template<typename Enum, std::size_t Size>
+constexpr auto choice<Enum, Size>::find(std::string_view key) const
+    -> std::optional<Enum>
+{
+    const auto value=hash(key);
+    
+    if (const auto index=m_slots[slot(value, m_seeds[value%buckets])];
+        index<Size && m_entries[index].first==key) {
+        return m_entries[index].second;
+    }
+    
+    return std::nullopt;
+}
+
+template<typename Enum, std::size_t Size>
+constexpr std::string_view choice<Enum, Size>::spelling(Enum value) const
+{
+    for (auto& entry:m_entries) {
+        if (entry.second==value) {
+            return entry.first;
+        }
+    }
+    
+    return {};
+}
+
+template<typename Enum, std::size_t Size>
+std::string choice<Enum, Size>::describe() const
+{
+    std::string result{"one of "};
+    
+    for (std::size_t index{0}; index<Size; ++index) {
+        if (index>0) {
+            result+=index+1<Size ? ", " : " or ";
+        }
+        
+        result+=m_entries[index].first;
+    }
+    
+    return result;
+}
+
+template<typename Enum, std::size_t Size>
+constexpr std::uint64_t choice<Enum, Size>::hash(std::string_view key)
+{
+    std::uint64_t result{0xcbf29ce484222325}; // FNV-1a
+    
+    for (unsigned char character:key) {
+        result=(result^character)*0x100000001b3;
+    }
+    
+    return result;
+}
+
+template<typename Enum, std::size_t Size>
+constexpr std::size_t choice<Enum, Size>::slot(std::uint64_t hash,
+    std::uint32_t seed)
+{
+    hash+=(seed+1)*0x9e3779b97f4a7c15; // splitmix64 finalizer
+    hash=(hash^(hash>>30))*0xbf58476d1ce4e5b9;
+    hash=(hash^(hash>>27))*0x94d049bb133111eb;
+    
+    return (hash^(hash>>31))&(slots-1);
+}
+
+template<typename Enum, std::size_t Size>
+constexpr auto spell(const std::pair<std::string_view, Enum> (&entries)[Size])
+{
+    return choice<Enum, Size>{entries};
+}
+
+template<typename Enum>
+cast_result caster<Enum, std::void_t<decltype(choices<Enum>::table)>>::apply(
+    std::string_view value, Enum& result)
+{
+    static const auto type=choices<Enum>::table.describe();
+    
+    if (auto entry=choices<Enum>::table.find(value); entry) {
+        result=*entry;
+        
+        return {};
+    }
+    
+    return {cast_result::outcome::invalid, type.c_str()};
+}
+
+}
+
+#endif
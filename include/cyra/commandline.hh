@@ -20,17 +20,29 @@
 
 #include <cyra/container.hh>
 
+#include <cstddef>
+#include <memory>
 #include <string>
-#include <queue>
+#include <string_view>
+#include <vector>
 
 namespace cyra {
 
+struct shell {}; // split a single string with POSIX shell quoting
+struct separated {}; // NUL-terminated arguments, as in /proc/PID/cmdline
+
 class commandline: public range {
     friend class parser;
     
 public:
     commandline(int count, const char* const* values);
     
+    // single and double quotes and backslash escapes, no expansion
+    commandline(std::string line, shell syntax);
+    
+    commandline(std::string buffer, separated syntax);
+    commandline(int descriptor, separated syntax); // read until end of file
+    
     template<typename Container>
     commandline(Container&& arguments);
     
@@ -46,10 +58,23 @@ public:
     const std::string& path() const noexcept;
     
 private:
-    std::queue<std::string> m_arguments;
+    // both shared by copies, whose tokens view the same storage
+    
+    std::shared_ptr<const std::string> m_source; // viewed by plain tokens
+    std::shared_ptr<list<pooled>> m_pool; // copied or unescaped tokens
+    
+    std::vector<std::string_view> m_arguments;
+    std::size_t m_next{0}; // first argument not yet parsed
+    
     std::string m_path;
     
     bool m_good{false}; // whether parsing has succeeded
+    
+    void push(std::string_view argument); // copied into the pool
+    void start(); // take the path from the first argument
+    
+    void tokenize();
+    void split();
 };
 
 }
@@ -22,8 +22,6 @@
 #   error commandline.tcc is intended for internal use only
 #endif
 
-#include <cyra/exception.hh>
-
 #include <iterator>
 
 namespace cyra {
@@ -43,14 +41,12 @@ commandline::commandline(const Container& arguments)
 
 template<typename Iterator>
 commandline::commandline(Iterator first, Iterator last)
-    : m_arguments{{first, last}}
 {
-    if (m_arguments.empty()) {
-        throw initialization_error{"no arguments supplied to commandline"};
+    for (; first!=last; ++first) {
+        push(*first);
     }
     
-    m_path=m_arguments.front();
-    m_arguments.pop();
+    start();
 }
 
 }
@@ -0,0 +1,74 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_COMPLETION_HH
+#define CYRA_COMPLETION_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cyra {
+
+class range;
+
+class completion {
+public:
+    enum class category {
+        argument, value, operand
+    };
+    
+    struct candidates {
+        category type; // what the word being completed is expected to be
+        
+        std::string option; // option awaiting a value, if any
+        std::vector<std::string> keys; // sorted keys matching the word
+    };
+    
+    explicit completion(range& root); // populates deferred commands
+    explicit completion(const std::string& path); // memory-mapped index
+    
+    // words following the program path, the last one being completed
+    candidates operator()(const std::vector<std::string>& words) const;
+    
+    void save(const std::string& path) const;
+    
+private:
+    std::shared_ptr<const char> m_data; // flat index, see completion.cc
+    std::size_t m_size{0};
+    
+    std::uint32_t m_scopes{0};
+    std::uint32_t m_entries{0};
+    
+    std::size_t scope(std::uint32_t index) const noexcept;
+    std::size_t entry(std::uint32_t index) const noexcept;
+    
+    std::string_view key(std::uint32_t index) const;
+    
+    std::pair<std::uint32_t, std::uint32_t> prefix(std::uint32_t scope,
+        std::string_view key) const;
+    
+    void load();
+};
+
+}
+
+#endif
@@ -0,0 +1,80 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_CONFIGURATION_HH
+#define CYRA_CONFIGURATION_HH
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cyra {
+
+/*  Flat configuration in the form
+    
+    # comment
+    jobs = 4
+    verbose
+    
+    [remote.add]
+    url = "https://example.org"
+    
+    where each key names the long option --key of the range selected by the
+    section, a dotted path of commands below the root. Keys, values and
+    sections are views into the text, quotes around a value are stripped but
+    nothing is unescaped.
+*/
+
+class configuration {
+public:
+    struct entry {
+        std::string_view section; // empty for the root range
+        std::string_view key;
+        std::optional<std::string_view> value; // none for a bare key
+        
+        std::size_t line;
+    };
+    
+    using const_iterator=std::vector<entry>::const_iterator;
+    
+    explicit configuration(const std::string& path); // memory-mapped
+    explicit configuration(std::string_view text, // borrowed, not copied
+        const std::string& name="configuration");
+    
+    const std::string& name() const noexcept; // path or given name
+    
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    
+    std::size_t size() const noexcept;
+    
+private:
+    std::shared_ptr<const char> m_data;
+    std::size_t m_size{0};
+    
+    std::string m_name;
+    std::vector<entry> m_entries;
+    
+    void tokenize();
+};
+
+}
+
+#endif
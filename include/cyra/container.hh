@@ -18,14 +18,25 @@
 #ifndef CYRA_CONTAINER_HH
 #define CYRA_CONTAINER_HH
 
+#include <any>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace cyra {
 
 class argument;
+class pool;
+class schema;
 
 template<typename Type>
 class container: protected std::vector<Type> {
@@ -46,13 +57,45 @@ protected:
 
 class range: public container<std::reference_wrapper<argument>> {
 public:
+    enum class relation {
+        exclusion, // at most one of the arguments is set
+        inclusion, // at least one of the arguments is set
+        implication // the first argument being set requires all others
+    };
+    
+    struct constraint {
+        relation type;
+        std::vector<std::reference_wrapper<const argument>> objects;
+    };
+    
     std::optional<value_type> operator[](const std::string& key) const; // match
     
     std::optional<value_type> query(const std::string& key) const;
     std::optional<value_type> match(const std::string& key) const;
     
-    void attach(argument& object);
+    using std::vector<value_type>::reserve;
+    
+    void attach(argument& object); // linear in the size of the range
     void detach(const argument& object);
+    
+    template<typename Iterator>
+    void attach(Iterator first, Iterator last); // linear in the total size
+    
+    void constrain(relation type, // objects have to be attached first
+        std::vector<std::reference_wrapper<const argument>> objects);
+    
+    const std::vector<constraint>& constraints() const noexcept;
+    
+    schema& index() const; // built on demand, reset by attach and detach
+    
+    // offer the index of another range, taken instead of a new one if it
+    // describes the same arguments and constraints
+    void recycle(const range& other) noexcept;
+    
+private:
+    std::vector<constraint> m_constraints;
+    mutable std::shared_ptr<schema> m_index;
+    mutable std::shared_ptr<schema> m_spare; // offered by recycle
 };
 
 template<typename... Arguments>
@@ -61,16 +104,44 @@ void attach(range& scope, argument& object, Arguments&&... objects);
 template<typename... Arguments>
 void detach(range& scope, argument& object, Arguments&&... objects);
 
+template<typename... Arguments>
+void exclude(range& scope, argument& object, Arguments&&... objects);
+
+template<typename... Arguments>
+void require(range& scope, argument& object, Arguments&&... objects);
+
+template<typename... Arguments>
+void imply(range& scope, argument& premise, Arguments&&... objects);
+
 class tray {
 public:
     virtual ~tray()=default;
     
     virtual void append(std::string value)=0;
+    virtual void clear(); // drop all values, unsupported by default
+    
+    // append in order, casting on the workers where supported, and throw
+    // invalid_element for the first value that fails
+    virtual void extend(std::vector<std::string> values, pool* workers);
+    
+    // copy of the stored values for a later restore, empty if unsupported
+    virtual std::any snapshot() const;
+    virtual void restore(const std::any& values);
     
 protected:
     tray()=default;
 };
 
+template<typename Type>
+struct element { // what a list of Type holds per value
+    using type=Type;
+    
+    static constexpr bool sequence{true}; // values kept in order of arrival
+};
+
+template<typename Type>
+using element_t=typename element<Type>::type;
+
 template<typename Type>
 class list: public tray, public container<Type> {
 public:
@@ -78,6 +149,220 @@ public:
     using std::vector<Type>::at;
     
     virtual void append(std::string value) override;
+    virtual void clear() override;
+    
+    virtual void extend(std::vector<std::string> values,
+        pool* workers) override;
+    
+    virtual std::any snapshot() const override;
+    virtual void restore(const std::any& values) override;
+};
+
+template<typename Type, char Delimiter=','>
+struct delimited {}; // split each value into several elements
+
+template<typename Type, char Delimiter>
+struct element<delimited<Type, Delimiter>>: element<Type> {};
+
+template<typename Type, char Delimiter>
+class list<delimited<Type, Delimiter>>: public list<Type> {
+public:
+    using std::vector<Type>::size;
+    
+    virtual void append(std::string value) override;
+    
+    virtual void extend(std::vector<std::string> values,
+        pool* workers) override; // in order on the calling thread
+};
+
+template<typename Type>
+struct lazy {}; // store raw values, cast on first access
+
+template<typename Type>
+struct element<lazy<Type>>: element<Type> {};
+
+template<typename Type>
+class list<lazy<Type>>: public tray {
+public:
+    explicit operator bool() const noexcept;
+    bool empty() const noexcept;
+    
+    std::size_t size() const noexcept;
+    
+    const Type& operator[](std::size_t index) const; // cast and cache, locked
+    const Type& at(std::size_t index) const;
+    
+    const Type& front() const;
+    const Type& back() const;
+    
+    const std::string& raw(std::size_t index) const;
+    
+    void validate() const; // cast all values not yet cached
+    
+    virtual void append(std::string value) override;
+    virtual void clear() override;
+    
+private:
+    std::vector<std::string> m_values;
+    
+    mutable std::mutex m_lock; // concurrent reads fill the cache
+    mutable std::vector<std::optional<Type>> m_cache;
+};
+
+template<typename Owner>
+class indexed_iterator { // reads through the owner's operator[]
+public:
+    // an input iterator, since elements are returned by value
+    using iterator_category=std::input_iterator_tag;
+    using value_type=std::decay_t<decltype(std::declval<const Owner&>()[0])>;
+    using difference_type=std::ptrdiff_t;
+    using pointer=void;
+    using reference=value_type;
+    
+    indexed_iterator() noexcept=default;
+    indexed_iterator(const Owner& owner, std::size_t index) noexcept;
+    
+    reference operator*() const;
+    
+    indexed_iterator& operator++() noexcept;
+    indexed_iterator operator++(int) noexcept;
+    
+    bool operator==(const indexed_iterator& other) const noexcept;
+    bool operator!=(const indexed_iterator& other) const noexcept;
+    
+private:
+    const Owner* m_owner{nullptr};
+    std::size_t m_index{0};
+};
+
+struct pooled {}; // strings in one contiguous buffer, read as views
+struct interned {}; // as pooled, each distinct string stored once
+
+template<>
+struct element<pooled>: element<std::string> {}; // copied out of the pool
+
+template<>
+struct element<interned>: element<std::string> {};
+
+template<>
+class list<pooled>: public tray {
+public:
+    using iterator=indexed_iterator<list>;
+    
+    explicit operator bool() const noexcept;
+    bool empty() const noexcept;
+    
+    std::size_t size() const noexcept;
+    std::size_t bytes() const noexcept; // characters held by the pool
+    
+    iterator begin() const noexcept;
+    iterator end() const noexcept;
+    
+    std::string_view operator[](std::size_t index) const; // stable views
+    std::string_view at(std::size_t index) const;
+    
+    std::string_view front() const;
+    std::string_view back() const;
+    
+    void reserve(std::size_t count);
+    
+    void push(std::string_view value); // append without a string copy
+    virtual void append(std::string value) override;
+    virtual void clear() override;
+    
+private:
+    static constexpr std::size_t block{65536}; // larger values get their own
+    
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    std::size_t m_used{block}; // in the last shared block
+    
+    std::size_t m_bytes{0};
+    std::vector<std::string_view> m_values;
+};
+
+template<>
+class list<interned>: public tray {
+public:
+    using iterator=indexed_iterator<list>;
+    
+    explicit operator bool() const noexcept;
+    bool empty() const noexcept;
+    
+    std::size_t size() const noexcept;
+    std::size_t distinct() const noexcept;
+    
+    iterator begin() const noexcept;
+    iterator end() const noexcept;
+    
+    std::string_view operator[](std::size_t index) const;
+    std::string_view at(std::size_t index) const;
+    
+    std::string_view front() const;
+    std::string_view back() const;
+    
+    virtual void append(std::string value) override;
+    virtual void clear() override;
+    
+private:
+    list<pooled> m_strings; // each distinct value once
+    
+    std::vector<std::uint32_t> m_items; // string per value
+    std::vector<std::uint32_t> m_slots; // open addressing, string+1 or 0
+    std::vector<std::size_t> m_hashes; // per string
+};
+
+enum class duplicate {
+    last, // a repeated key replaces the value
+    first, // a repeated key is validated, then ignored
+    error, // a repeated key throws duplicate_key
+    multiple // a repeated key adds another value
+};
+
+template<typename Key, typename Value, duplicate Policy=duplicate::last>
+struct mapping {}; // split each value on the first = into key and value
+
+template<typename Key, typename Value, duplicate Policy>
+struct element<mapping<Key, Value, Policy>> {
+    using type=std::pair<Key, Value>;
+    
+    static constexpr bool sequence{false}; // repeated keys may be merged
+};
+
+template<typename Key, typename Value, duplicate Policy>
+class list<mapping<Key, Value, Policy>>: public tray {
+public:
+    using value_type=std::pair<Key, Value>;
+    
+    explicit operator bool() const noexcept;
+    bool empty() const noexcept;
+    
+    std::size_t size() const noexcept; // entries, counting repeated keys
+    
+    auto begin() const noexcept; // in order of first appearance
+    auto end() const noexcept;
+    
+    const Value* find(const Key& key) const; // first value, or nullptr
+    const Value& at(const Key& key) const;
+    
+    bool contains(const Key& key) const;
+    
+    std::vector<std::reference_wrapper<const Value>> values(
+        const Key& key) const; // all values in order, for multiple
+    
+    virtual void append(std::string value) override;
+    virtual void clear() override;
+    
+private:
+    static constexpr std::size_t none{0}; // slots hold entry indices+1
+    
+    std::size_t locate(const Key& key, std::size_t hash) const; // slot
+    
+    void grow();
+    
+    std::vector<value_type> m_entries;
+    std::vector<std::size_t> m_hashes; // per entry
+    std::vector<std::size_t> m_next; // per entry, the next equal key
+    std::vector<std::size_t> m_slots; // open addressing, linear probing
 };
 
 }
@@ -23,9 +23,16 @@
 #endif
 
 #include <cyra/cast.hh>
+#include <cyra/exception.hh>
+#include <cyra/pool.hh>
 
+#include <algorithm>
+#include <atomic>
 #include <initializer_list>
+#include <iterator>
+#include <stdexcept>
 #include <type_traits>
+#include <unordered_set>
 #include <utility>
 
 namespace cyra {
@@ -36,14 +43,32 @@ container<Type>::operator bool() const noexcept
     return !empty();
 }
 
+template<typename Iterator>
+void range::attach(Iterator first, Iterator last)
+{
+    std::unordered_set<const argument*> members;
+    members.reserve(std::vector<value_type>::size());
+    
+    for (const argument& entry:*this) {
+        members.insert(&entry);
+    }
+    
+    for (; first!=last; ++first) {
+        if (argument& object=*first; members.insert(&object).second) {
+            push_back(object);
+        }
+    }
+    
+    m_index.reset();
+}
+
 template<typename... Arguments>
 void attach(range& scope, argument& object, Arguments&&... objects)
 {
     using list=std::initializer_list<std::reference_wrapper<argument>>;
     
-    for (auto item:list{object, std::forward<Arguments>(objects)...}) {
-        scope.attach(item);
-    }
+    const list items{object, std::forward<Arguments>(objects)...};
+    scope.attach(items.begin(), items.end());
 }
 
 template<typename... Arguments>
@@ -56,13 +81,420 @@ void detach(range& scope, argument& object, Arguments&&... objects)
     }
 }
 
+template<typename... Arguments>
+void exclude(range& scope, argument& object, Arguments&&... objects)
+{
+    scope.constrain(range::relation::exclusion,
+        {object, std::forward<Arguments>(objects)...});
+}
+
+template<typename... Arguments>
+void require(range& scope, argument& object, Arguments&&... objects)
+{
+    scope.constrain(range::relation::inclusion,
+        {object, std::forward<Arguments>(objects)...});
+}
+
+template<typename... Arguments>
+void imply(range& scope, argument& premise, Arguments&&... objects)
+{
+    scope.constrain(range::relation::implication,
+        {premise, std::forward<Arguments>(objects)...});
+}
+
 template<typename Type>
 void list<Type>::append(std::string value)
 {
     if constexpr (std::is_same_v<Type, decltype(value)>) {
         std::vector<Type>::push_back(std::move(value));
     } else {
-        std::vector<Type>::push_back(cast<Type>(value));
+        Type result{};
+        caster<Type>::apply(value, result).check(value);
+        
+        std::vector<Type>::push_back(std::move(result));
+    }
+}
+
+template<typename Type>
+void list<Type>::clear()
+{
+    std::vector<Type>::clear();
+}
+
+template<typename Type>
+void list<Type>::extend(std::vector<std::string> values, pool* workers)
+{
+    constexpr std::size_t threshold{4096}; // below, threads cost more
+    
+    if constexpr (std::is_same_v<Type, std::string>) {
+        std::vector<Type>::insert(std::vector<Type>::end(),
+            std::make_move_iterator(values.begin()),
+            std::make_move_iterator(values.end()));
+    } else if constexpr (std::is_same_v<Type, bool>) { // packed bits
+        tray::extend(std::move(values), workers);
+    } else {
+        if (!workers || workers->size()<2 || values.size()<threshold ||
+            workers->inside()) { // already parallel, e.g. within a batch
+            tray::extend(std::move(values), workers);
+            return;
+        }
+        
+        std::vector<Type> results(values.size());
+        std::atomic<std::size_t> failure{values.size()}; // lowest index
+        
+        workers->run(values.size(), [&](std::size_t index, std::size_t) {
+            if (index>failure.load(std::memory_order_relaxed)) {
+                return;
+            }
+            
+            if (!caster<Type>::apply(values[index], results[index])) {
+                auto current=failure.load();
+                
+                while (index<current &&
+                    !failure.compare_exchange_weak(current, index)) {
+                }
+            }
+        });
+        
+        if (const auto index=failure.load(); index<values.size()) {
+            try {
+                caster<Type>::apply(values[index],
+                    results[index]).check(values[index]);
+            } catch (const cast_error&) {
+                throw invalid_element{index, std::current_exception()};
+            }
+        }
+        
+        std::vector<Type>::insert(std::vector<Type>::end(),
+            std::make_move_iterator(results.begin()),
+            std::make_move_iterator(results.end()));
+    }
+}
+
+template<typename Type>
+std::any list<Type>::snapshot() const
+{
+    if constexpr (std::is_copy_constructible_v<Type>) {
+        return static_cast<const std::vector<Type>&>(*this);
+    } else {
+        return {};
+    }
+}
+
+template<typename Type>
+void list<Type>::restore(const std::any& values)
+{
+    if constexpr (std::is_copy_constructible_v<Type>) {
+        static_cast<std::vector<Type>&>(*this)=
+            std::any_cast<const std::vector<Type>&>(values);
+    }
+}
+
+template<typename Type, char Delimiter>
+void list<delimited<Type, Delimiter>>::append(std::string value)
+{
+    cast(value, Delimiter, static_cast<std::vector<Type>&>(*this));
+}
+
+template<typename Type, char Delimiter>
+void list<delimited<Type, Delimiter>>::extend(std::vector<std::string> values,
+    pool* workers)
+{
+    tray::extend(std::move(values), workers);
+}
+
+template<typename Type>
+list<lazy<Type>>::operator bool() const noexcept
+{
+    return !empty();
+}
+
+template<typename Type>
+bool list<lazy<Type>>::empty() const noexcept
+{
+    return m_values.empty();
+}
+
+template<typename Type>
+std::size_t list<lazy<Type>>::size() const noexcept
+{
+    return m_values.size();
+}
+
+template<typename Type>
+const Type& list<lazy<Type>>::operator[](std::size_t index) const
+{
+    // cached values are never written again, so their references stay
+    // valid once the lock is released
+    
+    const std::lock_guard<std::mutex> lock{m_lock};
+    
+    if (auto& entry=m_cache[index]; !entry) {
+        entry=cast<Type>(m_values[index]);
+    }
+    
+    return m_cache[index].value();
+}
+
+template<typename Type>
+const Type& list<lazy<Type>>::at(std::size_t index) const
+{
+    if (index>=size()) {
+        throw std::out_of_range{"lazy list index out of range"};
+    }
+    
+    return operator[](index);
+}
+
+template<typename Type>
+const Type& list<lazy<Type>>::front() const
+{
+    return operator[](0);
+}
+
+template<typename Type>
+const Type& list<lazy<Type>>::back() const
+{
+    return operator[](size()-1);
+}
+
+template<typename Type>
+const std::string& list<lazy<Type>>::raw(std::size_t index) const
+{
+    return m_values.at(index);
+}
+
+template<typename Type>
+void list<lazy<Type>>::validate() const
+{
+    for (std::size_t index{0}; index<size(); ++index) {
+        operator[](index);
+    }
+}
+
+template<typename Type>
+void list<lazy<Type>>::append(std::string value)
+{
+    m_values.push_back(std::move(value));
+    m_cache.emplace_back();
+}
+
+template<typename Type>
+void list<lazy<Type>>::clear()
+{
+    m_values.clear();
+    m_cache.clear();
+}
+
+template<typename Owner>
+indexed_iterator<Owner>::indexed_iterator(const Owner& owner,
+    std::size_t index) noexcept
+    : m_owner{&owner},
+        m_index{index}
+{
+}
+
+template<typename Owner>
+auto indexed_iterator<Owner>::operator*() const -> reference
+{
+    return (*m_owner)[m_index];
+}
+
+template<typename Owner>
+auto indexed_iterator<Owner>::operator++() noexcept -> indexed_iterator&
+{
+    ++m_index;
+    
+    return *this;
+}
+
+template<typename Owner>
+auto indexed_iterator<Owner>::operator++(int) noexcept -> indexed_iterator
+{
+    auto previous=*this;
+    ++m_index;
+    
+    return previous;
+}
+
+template<typename Owner>
+bool indexed_iterator<Owner>::operator==(
+    const indexed_iterator& other) const noexcept
+{
+    return m_owner==other.m_owner && m_index==other.m_index;
+}
+
+template<typename Owner>
+bool indexed_iterator<Owner>::operator!=(
+    const indexed_iterator& other) const noexcept
+{
+    return !(*this==other);
+}
+
+template<typename Key, typename Value, duplicate Policy>
+list<mapping<Key, Value, Policy>>::operator bool() const noexcept
+{
+    return !empty();
+}
+
+template<typename Key, typename Value, duplicate Policy>
+bool list<mapping<Key, Value, Policy>>::empty() const noexcept
+{
+    return m_entries.empty();
+}
+
+template<typename Key, typename Value, duplicate Policy>
+std::size_t list<mapping<Key, Value, Policy>>::size() const noexcept
+{
+    return m_entries.size();
+}
+
+template<typename Key, typename Value, duplicate Policy>
+auto list<mapping<Key, Value, Policy>>::begin() const noexcept
+{
+    return m_entries.begin();
+}
+
+template<typename Key, typename Value, duplicate Policy>
+auto list<mapping<Key, Value, Policy>>::end() const noexcept
+{
+    return m_entries.end();
+}
+
+template<typename Key, typename Value, duplicate Policy>
+const Value* list<mapping<Key, Value, Policy>>::find(const Key& key) const
+{
+    if (const auto slot=locate(key, std::hash<Key>{}(key));
+        slot<m_slots.size() && m_slots[slot]!=none) {
+        return &m_entries[m_slots[slot]-1].second;
+    }
+    
+    return nullptr;
+}
+
+template<typename Key, typename Value, duplicate Policy>
+const Value& list<mapping<Key, Value, Policy>>::at(const Key& key) const
+{
+    if (const auto result=find(key); result) {
+        return *result;
+    }
+    
+    throw std::out_of_range{"mapping key not found"};
+}
+
+template<typename Key, typename Value, duplicate Policy>
+bool list<mapping<Key, Value, Policy>>::contains(const Key& key) const
+{
+    return find(key)!=nullptr;
+}
+
+template<typename Key, typename Value, duplicate Policy>
+auto list<mapping<Key, Value, Policy>>::values(const Key& key) const
+    -> std::vector<std::reference_wrapper<const Value>>
+{
+    std::vector<std::reference_wrapper<const Value>> result;
+    
+    if (const auto slot=locate(key, std::hash<Key>{}(key));
+        slot<m_slots.size() && m_slots[slot]!=none) {
+        for (auto index=m_slots[slot]; index!=none; index=m_next[index-1]) {
+            result.push_back(m_entries[index-1].second);
+        }
+    }
+    
+    return result;
+}
+
+template<typename Key, typename Value, duplicate Policy>
+void list<mapping<Key, Value, Policy>>::append(std::string value)
+{
+    const auto separator=value.find('=');
+    
+    if (separator==value.npos) {
+        throw invalid_type{value, "a key=value pair"};
+    }
+    
+    const std::string_view text{value};
+    const auto key=text.substr(0, separator), data=text.substr(separator+1);
+    
+    value_type entry{};
+    
+    caster<Key>::apply(key, entry.first).check(key);
+    caster<Value>::apply(data, entry.second).check(data);
+    
+    if (m_entries.size()+1>m_slots.size()/2) {
+        grow();
+    }
+    
+    const auto hash=std::hash<Key>{}(entry.first);
+    const auto slot=locate(entry.first, hash);
+    
+    if (auto& index=m_slots[slot]; index==none) {
+        index=m_entries.size()+1;
+    } else if (Policy==duplicate::last) {
+        m_entries[index-1].second=std::move(entry.second);
+        return;
+    } else if (Policy==duplicate::first) {
+        return;
+    } else if (Policy==duplicate::error) {
+        throw duplicate_key{std::string{key}};
+    } else {
+        auto last=index;
+        
+        while (m_next[last-1]!=none) {
+            last=m_next[last-1];
+        }
+        
+        m_next[last-1]=m_entries.size()+1;
+    }
+    
+    m_entries.push_back(std::move(entry));
+    m_hashes.push_back(hash);
+    m_next.push_back(none);
+}
+
+template<typename Key, typename Value, duplicate Policy>
+void list<mapping<Key, Value, Policy>>::clear()
+{
+    m_entries.clear();
+    m_hashes.clear();
+    m_next.clear();
+    
+    std::fill(m_slots.begin(), m_slots.end(), none);
+}
+
+template<typename Key, typename Value, duplicate Policy>
+std::size_t list<mapping<Key, Value, Policy>>::locate(const Key& key,
+    std::size_t hash) const
+{
+    if (m_slots.empty()) {
+        return 0;
+    }
+    
+    const auto mask=m_slots.size()-1;
+    auto slot=hash&mask;
+    
+    for (; m_slots[slot]!=none; slot=(slot+1)&mask) {
+        if (const auto index=m_slots[slot]-1;
+            m_hashes[index]==hash && m_entries[index].first==key) {
+            break;
+        }
+    }
+    
+    return slot;
+}
+
+template<typename Key, typename Value, duplicate Policy>
+void list<mapping<Key, Value, Policy>>::grow()
+{
+    const auto mask=std::max<std::size_t>(m_slots.size()*2, 16)-1;
+    
+    m_slots.assign(mask+1, none);
+    
+    for (std::size_t index{0}; index<m_entries.size(); ++index) {
+        if (auto& slot=m_slots[locate(m_entries[index].first,
+            m_hashes[index])]; slot==none) {
+            slot=index+1; // repeated keys stay chained to the first
+        }
     }
 }
 
@@ -0,0 +1,43 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_ENVIRONMENT_HH
+#define CYRA_ENVIRONMENT_HH
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+namespace cyra {
+
+class environment { // hashed snapshot of NAME=value entries
+public:
+    environment(); // of the process environment
+    explicit environment(const char* const* entries); // null terminated
+    
+    std::optional<std::string_view> operator[](std::string_view name) const;
+    
+    std::size_t size() const noexcept;
+    
+private:
+    std::unordered_map<std::string_view, std::string_view> m_entries;
+};
+
+}
+
+#endif
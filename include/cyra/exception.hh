@@ -21,6 +21,7 @@
 #include <exception>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace cyra {
 
@@ -114,6 +115,18 @@ private:
     std::size_t m_decrement;
 };
 
+class file_error: public runtime_error {
+public:
+    explicit file_error(const std::string& path, const std::string& reason);
+    
+    const std::string& path() const noexcept;
+    const std::string& reason() const noexcept;
+    
+private:
+    std::shared_ptr<std::string> m_path;
+    std::shared_ptr<std::string> m_reason;
+};
+
 class parsing_error: public runtime_error {
     using runtime_error::runtime_error;
 };
@@ -122,11 +135,28 @@ class invalid_argument: public parsing_error {
 public:
     explicit invalid_argument(const std::string& argument);
     explicit invalid_argument(const std::string& type, const std::string& key);
+    explicit invalid_argument(const std::string& type,
+        const std::string& key, std::vector<std::string> suggestions);
+    
+    const std::string& description() const noexcept;
+    const std::vector<std::string>& suggestions() const noexcept; // ranked
+    
+private:
+    std::shared_ptr<std::string> m_description;
+    std::shared_ptr<std::vector<std::string>> m_suggestions;
+};
+
+class ambiguous_argument: public parsing_error {
+public:
+    explicit ambiguous_argument(const std::string& type,
+        const std::string& key, std::vector<std::string> candidates);
     
     const std::string& description() const noexcept;
+    const std::vector<std::string>& candidates() const noexcept;
     
 private:
     std::shared_ptr<std::string> m_description;
+    std::shared_ptr<std::vector<std::string>> m_candidates;
 };
 
 class count_error: public parsing_error {
@@ -167,6 +197,39 @@ private:
     std::size_t m_maximum;
 };
 
+class group_error: public count_error {
+public:
+    const std::vector<std::string>& descriptions() const noexcept;
+    
+protected:
+    explicit group_error(const std::string& what,
+        std::vector<std::string> descriptions);
+    
+private:
+    std::shared_ptr<std::vector<std::string>> m_descriptions;
+};
+
+class deficient_group: public group_error {
+public:
+    explicit deficient_group(std::vector<std::string> descriptions);
+};
+
+class excessive_group: public group_error {
+public:
+    explicit excessive_group(std::vector<std::string> descriptions);
+};
+
+class unmet_implication: public group_error {
+public:
+    explicit unmet_implication(const std::string& premise,
+        std::vector<std::string> descriptions);
+    
+    const std::string& premise() const noexcept;
+    
+private:
+    std::shared_ptr<std::string> m_premise;
+};
+
 class cast_error: public parsing_error {
     using parsing_error::parsing_error;
 };
@@ -174,13 +237,39 @@ class cast_error: public parsing_error {
 class invalid_type: public cast_error {
 public:
     explicit invalid_type(const std::string& value, const std::string& type);
+    explicit invalid_type(const std::string& value, const std::string& type,
+        std::size_t position);
     
     const std::string& value() const noexcept;
     const std::string& type() const noexcept;
     
+    std::size_t position() const noexcept; // std::string::npos if unknown
+    
 private:
     std::shared_ptr<std::string> m_value;
     std::shared_ptr<std::string> m_type;
+    
+    std::size_t m_position{std::string::npos};
+};
+
+class invalid_element: public cast_error {
+public:
+    explicit invalid_element(std::size_t index, std::exception_ptr cause);
+    explicit invalid_element(const std::string& argument, std::size_t token,
+        std::size_t index, std::exception_ptr cause);
+    
+    const std::string& argument() const noexcept; // empty if unknown
+    std::size_t token() const noexcept; // command line argument, 0 if none
+    
+    std::size_t index() const noexcept; // among the values of one parse
+    std::exception_ptr cause() const noexcept; // the original cast error
+    
+private:
+    std::shared_ptr<std::string> m_argument;
+    std::size_t m_token{0};
+    
+    std::size_t m_index;
+    std::exception_ptr m_cause;
 };
 
 class range_error: public cast_error {
@@ -211,6 +300,65 @@ private:
     std::shared_ptr<std::string> m_type;
 };
 
+class limit_exceeded: public parsing_error {
+public:
+    explicit limit_exceeded(const std::string& limit, std::size_t maximum);
+    
+    const std::string& limit() const noexcept; // member name within limits
+    std::size_t maximum() const noexcept;
+    
+private:
+    std::shared_ptr<std::string> m_limit;
+    std::size_t m_maximum;
+};
+
+class unterminated_quote: public parsing_error {
+public:
+    explicit unterminated_quote(char quote, std::size_t position);
+    
+    char quote() const noexcept; // backslash for a trailing escape
+    std::size_t position() const noexcept; // of the opening character
+    
+private:
+    char m_quote;
+    std::size_t m_position;
+};
+
+class duplicate_key: public parsing_error {
+public:
+    explicit duplicate_key(const std::string& key);
+    
+    const std::string& key() const noexcept;
+    
+private:
+    std::shared_ptr<std::string> m_key;
+};
+
+class missing_value: public parsing_error {
+public:
+    explicit missing_value(const std::string& key);
+    
+    const std::string& key() const noexcept;
+    
+private:
+    std::shared_ptr<std::string> m_key;
+};
+
+class configuration_error: public parsing_error {
+public:
+    explicit configuration_error(const std::string& path, std::size_t line,
+        std::exception_ptr cause);
+    
+    const std::string& path() const noexcept; // or the given name
+    std::size_t line() const noexcept;
+    std::exception_ptr cause() const noexcept; // the original parsing error
+    
+private:
+    std::shared_ptr<std::string> m_path;
+    std::size_t m_line;
+    std::exception_ptr m_cause;
+};
+
 }
 
 #endif
@@ -18,8 +18,10 @@
 #ifndef CYRA_LEXER_HH
 #define CYRA_LEXER_HH
 
+#include <cstddef>
 #include <optional>
 #include <string>
+#include <string_view>
 
 namespace cyra {
 
@@ -29,11 +31,11 @@ public:
         std::string key;
     };
     
-    struct option {
+    struct option { // value and rest view the input
         std::string key;
         
-        std::optional<std::string> value;
-        std::optional<std::string> rest;
+        std::optional<std::string_view> value;
+        std::optional<std::string_view> rest; // clustered, without a dash
     };
     
     struct operand {
@@ -47,6 +49,8 @@ public:
     
     lexer& operator<<(bool ready);
     lexer& operator<<(std::string input);
+    lexer& operator<<(std::string_view input); // reuses the input buffer
+    lexer& operator<<(const option& input); // its rest, in place
     
     template<typename Type>
     lexer& operator>>(Type& output);
@@ -54,25 +58,30 @@ public:
 protected:
     lexer()=default;
     
-    virtual bool write(const std::string& input, command& output)=0;
-    virtual bool write(const std::string& input, option& output)=0;
-    virtual bool write(const std::string& input, operand& output)=0;
+    bool clustered() const noexcept; // input is the rest of an option
+    
+    virtual bool write(std::string_view input, command& output)=0;
+    virtual bool write(std::string_view input, option& output)=0;
+    virtual bool write(std::string_view input, operand& output)=0;
     
 private:
     std::string m_input;
+    std::size_t m_first{0}; // of the input within the buffer
+    
+    bool m_clustered{false};
     bool m_ready{true};
 };
 
 class posix: public lexer {
 protected:
-    virtual bool write(const std::string& input, command& output) override;
-    virtual bool write(const std::string& input, option& output) override;
-    virtual bool write(const std::string& input, operand& output) override;
+    virtual bool write(std::string_view input, command& output) override;
+    virtual bool write(std::string_view input, option& output) override;
+    virtual bool write(std::string_view input, operand& output) override;
 };
 
 class gnu: public posix {
 protected:
-    virtual bool write(const std::string& input, option& output) override;
+    virtual bool write(std::string_view input, option& output) override;
 };
 
 }
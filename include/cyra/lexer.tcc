@@ -27,7 +27,7 @@ namespace cyra {
 template<typename Type>
 lexer& lexer::operator>>(Type& output)
 {
-    m_ready=write(m_input, output);
+    m_ready=write(std::string_view{m_input}.substr(m_first), output);
     return *this;
 }
 
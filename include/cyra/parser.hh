@@ -18,12 +18,39 @@
 #ifndef CYRA_PARSER_HH
 #define CYRA_PARSER_HH
 
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace cyra {
 
 class argument;
+class cache;
 class commandline;
+class configuration;
+class environment;
 class lexer;
+class pool;
 class range;
+class trace;
+class tray;
+
+struct statistics;
+
+struct limits { // per parse, all unbounded by default
+    static constexpr auto unbounded=std::numeric_limits<std::size_t>::max();
+    
+    std::size_t tokens{unbounded}; // arguments following the path
+    std::size_t length{unbounded}; // characters in one argument
+    std::size_t cluster{unbounded}; // options sharing one argument
+    std::size_t depth{unbounded}; // nested commands
+    std::size_t bytes{unbounded}; // characters stored as values
+};
 
 class parser {
 public:
@@ -31,6 +58,25 @@ public:
     
     commandline& operator()(commandline& terminal);
     
+    void abbreviate(bool enable) noexcept; // accept unique long option prefixes
+    
+    void measure(statistics* target) noexcept; // accumulate, null to disable
+    void record(trace* target) noexcept; // log decisions, null to disable
+    
+    void snapshot(const environment* source) noexcept; // null for each parse
+    void configure(const configuration* source) noexcept; // null to disable
+    
+    void restrict(const limits& bounds) noexcept; // for untrusted input
+    
+    // cast values in bulk on the workers once all arguments are routed,
+    // null to cast each value as it is stored; within a batch on the same
+    // pool, values are cast on the calling worker; either way, the first
+    // value routed that fails throws invalid_element, naming its argument
+    // and token
+    void pipeline(pool* workers) noexcept;
+    
+    void memoize(cache* results) noexcept; // reuse parses, null to disable
+    
 private:
     lexer& m_style;
     
@@ -40,9 +86,55 @@ private:
     bool m_operand{false}; // an operand is required
     bool m_value{false}; // an option value is required
     
+    bool m_abbreviate{false};
+    
+    statistics* m_statistics{nullptr};
+    trace* m_trace{nullptr};
+    
+    const environment* m_environment{nullptr};
+    const configuration* m_configuration{nullptr};
+    
+    std::size_t m_token{0}; // index of the current argument
+    
+    limits m_limits;
+    
+    std::size_t m_cluster{0}; // options lexed from the current argument
+    std::size_t m_depth{0};
+    std::size_t m_bytes{0};
+    
+    pool* m_pool{nullptr};
+    cache* m_cache{nullptr};
+    struct pending { // values routed to one tray, cast by flush
+        tray* storage;
+        
+        std::vector<std::string> values;
+        std::vector<std::size_t> tokens; // of each value, 0 if none
+        std::vector<std::size_t> orders; // of each value among all routed
+    };
+    
+    std::vector<pending> m_pending; // in order of first appearance
+    std::unordered_map<const tray*, std::size_t> m_slots; // into m_pending
+    std::size_t m_routed{0}; // values routed to any tray
+    
     bool command();
     bool option();
     bool operand();
+    
+    template<typename Type>
+    bool lex(Type& output);
+    
+    void process(commandline& terminal); // lex, route, store and verify
+    
+    void check(const commandline& terminal) const;
+    std::string key(const commandline& terminal) const; // for the cache
+    void store(tray& storage, std::string value);
+    void flush(); // pending values, reporting the first routed to fail
+    
+    void bind(range& scope, std::optional<environment>& local);
+    void load(range& root, const configuration& source);
+    void setting(range& scope, const std::string& key,
+        std::optional<std::string_view> value); // one entry of a file
+    bool assign(argument& object, std::string value);
 };
 
 template<typename Lexer>
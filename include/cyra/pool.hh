@@ -0,0 +1,85 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_POOL_HH
+#define CYRA_POOL_HH
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cyra {
+
+class pool { // fixed set of threads sharing work by stealing
+public:
+    using task=std::function<void(std::size_t index, std::size_t worker)>;
+    
+    explicit pool(std::size_t threads=std::thread::hardware_concurrency());
+    ~pool();
+    
+    pool(const pool&)=delete;
+    pool& operator=(const pool&)=delete;
+    
+    std::size_t size() const noexcept; // workers, numbered from zero
+    
+    // call work for every index below count and wait, rethrowing the first
+    // exception that escaped it, one run at a time; throws usage_error when
+    // called from one of the workers, which would wait for itself
+    void run(std::size_t count, const task& work);
+    
+    bool inside() const noexcept; // called from one of the workers
+    
+private:
+    using chunk=std::pair<std::size_t, std::size_t>; // first, last
+    
+    struct queue { // own chunks are taken from the front, stolen from the back
+        std::mutex lock;
+        std::deque<chunk> chunks;
+    };
+    
+    std::vector<std::thread> m_threads;
+    std::unique_ptr<queue[]> m_queues;
+    
+    std::mutex m_run; // serializes calls to run
+    
+    std::mutex m_lock; // guards everything below
+    std::condition_variable m_start;
+    std::condition_variable m_finish;
+    
+    const task* m_work{nullptr};
+    std::size_t m_generation{0};
+    std::size_t m_busy{0};
+    bool m_stop{false};
+    
+    std::exception_ptr m_error;
+    
+    void serve(std::size_t worker);
+    void drain(std::size_t worker, const task& work);
+    
+    bool take(std::size_t worker, chunk& output);
+};
+
+}
+
+#endif
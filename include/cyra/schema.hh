@@ -0,0 +1,136 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_SCHEMA_HH
+#define CYRA_SCHEMA_HH
+
+#include <cyra/argument.hh>
+#include <cyra/container.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cyra {
+
+class schema {
+public:
+    struct footprint {
+        std::size_t size; // number of arguments
+        
+        std::size_t legacy; // bytes held by qualifiers, quantifiers and range
+        std::size_t packed; // bytes held by the schema
+    };
+    
+    explicit schema(const range& scope);
+    
+    std::size_t size() const noexcept;
+    
+    std::optional<std::size_t> find(std::string_view key) const; // exact
+    
+    // position of a long key that is the only one its prefix resolves to
+    std::optional<std::size_t> abbreviate(std::string_view prefix) const;
+    
+    std::size_t keys() const noexcept; // number of distinct keys
+    
+    std::string_view key(std::size_t position) const noexcept; // sorted
+    std::size_t owner(std::size_t position) const noexcept; // argument index
+    
+    // nearest keys by edit distance, closest first
+    std::vector<std::string> suggest(std::string_view key,
+        std::size_t limit=3) const;
+    
+    // sorted key positions starting with prefix
+    std::pair<std::size_t, std::size_t> prefix(std::string_view key) const;
+    
+    argument& object(std::size_t index) const;
+    
+    argument::category type(std::size_t index) const noexcept;
+    
+    std::size_t minimum(std::size_t index) const noexcept;
+    std::size_t maximum(std::size_t index) const noexcept;
+    std::size_t count(std::size_t index) const noexcept;
+    
+    void refresh(); // reload counts from the argument objects
+    
+    // built from the same arguments, in order, and the same constraints
+    bool describes(const range& scope) const;
+    
+    // hash of keys, owners, types, count bounds and compiled constraints,
+    // equal for ranges built alike from other argument objects
+    std::uint64_t fingerprint() const noexcept;
+    
+    void enforce() const; // check the constraints of the range
+    
+    footprint measure() const;
+    
+private:
+    std::string m_pool; // distinct keys in sorted order
+    
+    std::vector<std::uint32_t> m_offsets; // key boundaries within the pool
+    std::vector<std::uint32_t> m_owners; // argument index of each key
+    
+    std::vector<argument*> m_objects;
+    
+    std::vector<std::uint8_t> m_types;
+    std::vector<std::uint32_t> m_minimum; // saturated to 32 bits
+    std::vector<std::uint32_t> m_maximum; // saturated to 32 bits
+    std::vector<std::uint32_t> m_counts; // saturated to 32 bits
+    
+    struct node {
+        std::uint32_t first; // child edges
+        std::uint32_t last;
+        
+        std::uint32_t position; // first key below this node
+        std::uint32_t owner; // shared by all keys below, or none
+    };
+    
+    struct rule {
+        range::relation type;
+        
+        std::uint32_t premise; // argument index, implications only
+        
+        std::uint32_t offset; // of the masks within m_masks
+        std::uint32_t first; // first word of the argument set covered
+        std::uint32_t last;
+    };
+    
+    std::vector<range::constraint> m_constraints; // as declared
+    std::vector<rule> m_rules; // compiled to bit masks
+    std::vector<std::uint64_t> m_masks;
+    
+    std::vector<node> m_nodes; // prefix trie over the long keys
+    
+    std::uint64_t m_fingerprint{0};
+    
+    std::vector<char> m_labels;
+    std::vector<std::uint32_t> m_children;
+    
+    void compile(const range& scope);
+    
+    std::size_t lower(std::string_view key) const noexcept;
+    std::size_t skip(std::size_t position, std::size_t length) const noexcept;
+    std::uint32_t grow(std::size_t first, std::size_t last, std::size_t depth);
+};
+
+}
+
+#endif
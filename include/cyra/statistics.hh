@@ -0,0 +1,78 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_STATISTICS_HH
+#define CYRA_STATISTICS_HH
+
+#include <cyra/schema.hh>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace cyra {
+
+struct statistics {
+    std::size_t tokens{0}; // arguments taken from the command line
+    std::size_t attempts{0}; // lexer writes, successful or not
+    std::size_t lookups{0}; // key queries against a scope
+    std::size_t stores{0}; // values handed to a tray, cast unless lazy
+    std::size_t heap_values{0}; // stored values too long for small strings
+    std::size_t exceptions{0}; // parses aborted by an exception
+    
+    std::chrono::nanoseconds lex{0};
+    std::chrono::nanoseconds match{0};
+    std::chrono::nanoseconds store{0}; // including casts
+    std::chrono::nanoseconds verify{0};
+    
+    schema::footprint footprint{0, 0, 0}; // of the root scope
+    
+    void dump(std::ostream& stream) const;
+};
+
+class trace {
+public:
+    enum class event: std::uint8_t {
+        token, command, option, value, operand, verify, error
+    };
+    
+    struct record {
+        event type;
+        std::uint32_t token; // index of the command line argument
+    };
+    
+    explicit trace(std::size_t capacity=64);
+    
+    void push(event type, std::size_t token) noexcept; // drops the oldest
+    void clear() noexcept;
+    
+    std::vector<record> records() const; // oldest first
+    
+    void dump(std::ostream& stream) const;
+    
+private:
+    std::vector<record> m_records;
+    
+    std::size_t m_next{0};
+    std::size_t m_size{0};
+};
+
+}
+
+#endif
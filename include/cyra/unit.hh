@@ -0,0 +1,63 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_UNIT_HH
+#define CYRA_UNIT_HH
+
+#include <cyra/cast.hh>
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace cyra {
+
+struct capacity { // bytes: 512MiB, 4kB, 1.5GB, 100
+    std::uint64_t bytes{0};
+};
+
+struct quantity { // scaled counts: 10k, 2M, 64Ki, 100
+    std::uint64_t count{0};
+};
+
+enum class dimension {
+    size, // B, kB, KB, MB, ..., EB and KiB, MiB, ..., EiB
+    count, // k, K, M, G, T, P, E and Ki, Mi, ..., Ei
+    time // ns, us, ms, s, m, min, h, d, also summed as in 1h30m
+};
+
+// parse a magnitude in units of numerator/denominator, exactly; a value
+// without a unit counts in those units already
+
+cast_result measure(std::string_view value, dimension type,
+    std::uint64_t numerator, std::uint64_t denominator,
+    std::uint64_t& result, bool& negative);
+
+cast_result convert(std::string_view value, capacity& result);
+cast_result convert(std::string_view value, quantity& result);
+
+template<typename Rep, typename Period>
+struct caster<std::chrono::duration<Rep, Period>> {
+    static cast_result apply(std::string_view value,
+        std::chrono::duration<Rep, Period>& result);
+};
+
+}
+
+#include "unit.tcc"
+
+#endif
@@ -0,0 +1,65 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CYRA_UNIT_TCC
+#define CYRA_UNIT_TCC
+
+#ifndef CYRA_UNIT_HH
+#   error unit.tcc is intended for internal use only
+#endif
+
+#include <limits>
+#include <type_traits>
+
+namespace cyra {
+
+template<typename Rep, typename Period>
+cast_result caster<std::chrono::duration<Rep, Period>>::apply(
+    std::string_view value, std::chrono::duration<Rep, Period>& result)
+{
+    static_assert(std::is_integral_v<Rep>,
+        "durations need an integral representation to be parsed exactly");
+    
+    using bound=std::numeric_limits<Rep>;
+    
+    std::uint64_t ticks{0};
+    bool negative{false};
+    
+    auto status=measure(value, dimension::time, Period::num, Period::den,
+        ticks, negative);
+    
+    if (!status) {
+        return status;
+    }
+    
+    if (negative && ticks>0ull-static_cast<std::uint64_t>(bound::min())) {
+        return {cast_result::outcome::underflow, status.type};
+    }
+    
+    if (!negative && ticks>static_cast<std::uint64_t>(bound::max())) {
+        return {cast_result::outcome::overflow, status.type};
+    }
+    
+    result=std::chrono::duration<Rep, Period>{
+        static_cast<Rep>(negative ? 0ull-ticks : ticks)};
+    
+    return status;
+}
+
+}
+
+#endif
@@ -20,11 +20,45 @@
 
 #include <algorithm>
 #include <limits>
-#include <regex>
 #include <utility>
 
 namespace cyra {
 
+namespace {
+
+bool alphanumeric(char character) noexcept
+{
+    return (character>='a' && character<='z') ||
+        (character>='A' && character<='Z') ||
+        (character>='0' && character<='9');
+}
+
+// [a-z0-9\-_]+
+bool command_key(const std::string& key) noexcept
+{
+    return !key.empty() && std::all_of(key.begin(), key.end(), [](char item) {
+        return (item>='a' && item<='z') || (item>='0' && item<='9') ||
+            item=='-' || item=='_';
+    });
+}
+
+// \-[[:alnum:]]
+bool brief_key(const std::string& key) noexcept
+{
+    return (key.size()==2 && key[0]=='-' && alphanumeric(key[1]));
+}
+
+// \-\-[[:alnum:]\-]+
+bool wide_key(const std::string& key) noexcept
+{
+    return key.size()>2 && key.compare(0, 2, "--")==0 &&
+        std::all_of(key.begin()+2, key.end(), [](char item) {
+        return alphanumeric(item) || item=='-';
+    });
+}
+
+}
+
 argument::qualifier::operator bool() const noexcept
 {
     return !empty();
@@ -84,6 +118,11 @@ const std::optional<std::string>& argument::qualifier::current() const noexcept
     return m_current;
 }
 
+const std::vector<std::string>& argument::qualifier::keys() const noexcept
+{
+    return m_keys;
+}
+
 bool argument::qualifier::query(const std::string& key) const
 {
     for (const auto& item:m_keys) {
@@ -112,8 +151,14 @@ argument::qualifier::qualifier(category type, std::vector<std::string> keys)
         m_standard=m_keys.front();
     }
     
-    std::sort(m_keys.begin(), m_keys.end());
-    m_keys.erase(std::unique(m_keys.begin(), m_keys.end()), m_keys.end());
+    // key lists are short, dropping duplicates in place beats sorting them
+    for (auto item=m_keys.begin(); item!=m_keys.end();) {
+        if (std::find(m_keys.begin(), item, *item)!=item) {
+            item=m_keys.erase(item);
+        } else {
+            ++item;
+        }
+    }
 }
 
 argument::quantifier::quantifier(std::size_t minimum, std::size_t maximum)
@@ -204,6 +249,35 @@ bool argument::set() const noexcept
     return (count()>0);
 }
 
+bool argument::defaulted() const noexcept
+{
+    return false;
+}
+
+auto argument::provenance() const noexcept -> origin
+{
+    if (m_origin!=origin::none) {
+        return m_origin;
+    }
+    
+    if (set()) {
+        return origin::commandline;
+    }
+    
+    return defaulted() ? origin::fallback : origin::none;
+}
+
+void argument::provenance(origin source) noexcept
+{
+    m_origin=source;
+}
+
+void argument::reset()
+{
+    *m_count-=m_count->value();
+    m_origin=origin::none;
+}
+
 auto argument::type() const noexcept -> category
 {
     return m_type;
@@ -231,10 +305,8 @@ argument::argument(category type,
 command::qualifier::qualifier(std::initializer_list<std::string> keys)
     : argument::qualifier{category::command, keys}
 {
-    static const std::regex expression{"[a-z0-9\\-_]+"};
-    
     for (const auto& key:keys) {
-        if (!std::regex_match(key, expression)) {
+        if (!command_key(key)) {
             throw invalid_qualifier{key, "command"};
         }
     }
@@ -245,18 +317,30 @@ auto command::name() const -> qualifier&
     return static_cast<qualifier&>(argument::name());
 }
 
+void command::defer(std::function<void(command&)> factory)
+{
+    m_factory=std::move(factory);
+}
+
+void command::populate()
+{
+    if (m_factory) {
+        const auto factory=std::move(m_factory);
+        m_factory=nullptr;
+        
+        factory(*this);
+    }
+}
+
 option::qualifier::qualifier(std::initializer_list<std::string> keys)
     : argument::qualifier{category::option, keys}
 {
-    static const std::regex brief{"\\-[[:alnum:]]"};
-    static const std::regex wide{"\\-\\-[[:alnum:]\\-]+"};
-    
     for (const auto& key:keys) {
-        if (std::regex_match(key, brief)) {
+        if (brief_key(key)) {
             if (!m_brief) {
                 m_brief=key;
             }
-        } else if (std::regex_match(key, wide)) {
+        } else if (wide_key(key)) {
             if (!m_wide) {
                 m_wide=key;
             }
@@ -293,4 +377,15 @@ auto option::name() const -> qualifier&
     return static_cast<qualifier&>(argument::name());
 }
 
+option& option::bind(std::string variable)
+{
+    m_variable=std::move(variable);
+    return *this;
+}
+
+auto option::variable() const noexcept -> const std::optional<std::string>&
+{
+    return m_variable;
+}
+
 }
@@ -0,0 +1,69 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cyra/argument.hh>
+#include <cyra/batch.hh>
+#include <cyra/container.hh>
+
+#include <utility>
+
+namespace cyra {
+
+result<void>::result(std::in_place_t) noexcept
+    : m_good{true}
+{
+}
+
+result<void>::result(std::exception_ptr error) noexcept
+    : m_error{std::move(error)}
+{
+}
+
+result<void>::operator bool() const noexcept
+{
+    return good();
+}
+
+bool result<void>::good() const noexcept
+{
+    return m_good;
+}
+
+void result<void>::value() const
+{
+    if (m_error) {
+        std::rethrow_exception(m_error);
+    }
+}
+
+std::exception_ptr result<void>::error() const noexcept
+{
+    return m_error;
+}
+
+void reset(range& scope)
+{
+    for (argument& object:scope) {
+        object.reset();
+        
+        if (const auto next=dynamic_cast<range*>(&object); next) {
+            reset(*next);
+        }
+    }
+}
+
+}
@@ -0,0 +1,305 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cyra/binary.hh>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#   include <immintrin.h>
+#   define CYRA_BINARY_VECTOR
+#endif
+
+namespace cyra {
+
+namespace {
+
+using outcome=cast_result::outcome;
+
+constexpr std::uint8_t invalid{0xFF};
+
+constexpr auto table(std::string_view alphabet)
+{
+    std::array<std::uint8_t, 256> result{};
+    
+    for (auto& entry:result) {
+        entry=invalid;
+    }
+    
+    for (std::size_t index{0}; index<alphabet.size(); ++index) {
+        result[static_cast<unsigned char>(alphabet[index])]=index;
+    }
+    
+    return result;
+}
+
+constexpr auto nibbles=table("0123456789abcdef");
+constexpr auto sextets=table(
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/");
+
+std::uint8_t nibble(char character)
+{
+    constexpr auto upper=table("0123456789ABCDEF");
+    
+    const auto index=static_cast<unsigned char>(character);
+    
+    return nibbles[index]!=invalid ? nibbles[index] : upper[index];
+}
+
+#ifdef CYRA_BINARY_VECTOR
+
+// 32 characters to 16 bytes with SSE2; returns a mask of the invalid ones
+
+std::uint32_t hexadecimal(const char* input, std::byte* output)
+{
+    __m128i halves[2];
+    std::uint32_t mask{0};
+    
+    for (int half{0}; half<2; ++half) {
+        const auto block=_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(input+16*half));
+        const auto lower=_mm_or_si128(block, _mm_set1_epi8(0x20));
+        
+        const auto digit=_mm_and_si128(
+            _mm_cmpgt_epi8(block, _mm_set1_epi8('0'-1)),
+            _mm_cmplt_epi8(block, _mm_set1_epi8('9'+1)));
+        const auto letter=_mm_and_si128(
+            _mm_cmpgt_epi8(lower, _mm_set1_epi8('a'-1)),
+            _mm_cmplt_epi8(lower, _mm_set1_epi8('f'+1)));
+        
+        const auto valid=static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_or_si128(digit, letter)));
+        
+        mask|=(~valid&0xFFFF)<<16*half;
+        
+        // the low four bits are the value of a digit and nine less than
+        // the value of a letter; then join each pair of nibbles
+        
+        const auto value=_mm_add_epi8(_mm_and_si128(block,
+            _mm_set1_epi8(0x0F)), _mm_and_si128(letter, _mm_set1_epi8(9)));
+        
+        halves[half]=_mm_or_si128(
+            _mm_slli_epi16(_mm_and_si128(value, _mm_set1_epi16(0x00FF)), 4),
+            _mm_srli_epi16(value, 8));
+    }
+    
+    if (mask==0) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+            _mm_packus_epi16(halves[0], halves[1]));
+    }
+    
+    return mask;
+}
+
+// 16 characters to 12 bytes with SSSE3, after W. Muła and D. Lemire;
+// returns a mask of the invalid characters
+
+__attribute__((target("ssse3")))
+std::uint32_t base64(const char* input, std::byte* output)
+{
+    const auto block=_mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+    
+    const auto low=_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const auto high=_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04,
+        0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const auto roll=_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0,
+        0, 0, 0, 0, 0, 0);
+    
+    const auto mask=_mm_set1_epi8(0x2F);
+    const auto upper=_mm_and_si128(_mm_srli_epi32(block, 4), mask);
+    
+    const auto classes=_mm_and_si128(_mm_shuffle_epi8(low,
+        _mm_and_si128(block, mask)), _mm_shuffle_epi8(high, upper));
+    
+    if (auto errors=_mm_movemask_epi8(_mm_cmpgt_epi8(classes,
+        _mm_setzero_si128())); errors!=0) {
+        return errors;
+    }
+    
+    const auto shift=_mm_shuffle_epi8(roll,
+        _mm_add_epi8(_mm_cmpeq_epi8(block, mask), upper));
+    const auto values=_mm_add_epi8(block, shift);
+    
+    // join four sextets into three bytes in each 32-bit lane
+    
+    const auto pairs=_mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const auto lanes=_mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    
+    alignas(16) std::byte bytes[16];
+    
+    _mm_store_si128(reinterpret_cast<__m128i*>(bytes), _mm_shuffle_epi8(lanes,
+        _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+    
+    std::memcpy(output, bytes, 12);
+    
+    return 0;
+}
+
+bool ssse3()
+{
+    static const bool result{(__builtin_cpu_init(),
+        __builtin_cpu_supports("ssse3")!=0)};
+    
+    return result;
+}
+
+#endif
+
+std::size_t first(std::uint32_t mask)
+{
+#ifdef CYRA_BINARY_VECTOR
+    return __builtin_ctz(mask);
+#else
+    std::size_t result{0};
+    
+    for (; (mask&1)==0; mask>>=1) {
+        ++result;
+    }
+    
+    return result;
+#endif
+}
+
+cast_result hexadecimal(std::string_view value, std::size_t offset,
+    std::vector<std::byte>& result)
+{
+    constexpr auto type="hexadecimal data";
+    
+    if (value.size()>=2 && value[0]=='0' && (value[1]=='x' || value[1]=='X')) {
+        value.remove_prefix(2);
+        offset+=2;
+    }
+    
+    if (value.size()%2!=0) { // the length, where the missing nibble belongs
+        return {outcome::invalid, type, offset+value.size()};
+    }
+    
+    result.resize(value.size()/2);
+    
+    std::size_t position{0};
+    auto output=result.data();
+    
+#ifdef CYRA_BINARY_VECTOR
+    for (; position+32<=value.size(); position+=32, output+=16) {
+        if (auto mask=hexadecimal(value.data()+position, output); mask) {
+            return {outcome::invalid, type, offset+position+first(mask)};
+        }
+    }
+#endif
+    
+    for (; position<value.size(); position+=2) {
+        const auto upper=nibble(value[position]);
+        const auto lower=nibble(value[position+1]);
+        
+        if (upper==invalid || lower==invalid) {
+            return {outcome::invalid, type,
+                offset+position+(upper==invalid ? 0 : 1)};
+        }
+        
+        *output++=static_cast<std::byte>(upper<<4|lower);
+    }
+    
+    return {outcome::success, type};
+}
+
+cast_result base64(std::string_view value, std::size_t offset,
+    std::vector<std::byte>& result)
+{
+    constexpr auto type="base64 data";
+    
+    auto size=value.size();
+    
+    if (size%4==0) { // padding only ever completes the last group
+        for (int count{0}; count<2 && size>0 && value[size-1]=='='; ++count) {
+            --size;
+        }
+    }
+    
+    if (size%4==1) {
+        return {outcome::invalid, type, offset+size-1};
+    }
+    
+    result.resize(size/4*3+(size%4==0 ? 0 : size%4-1));
+    
+    std::size_t position{0};
+    auto output=result.data();
+    
+#ifdef CYRA_BINARY_VECTOR
+    for (auto vector=ssse3(); vector && position+16<=size;
+        position+=16, output+=12) {
+        if (auto mask=base64(value.data()+position, output); mask) {
+            return {outcome::invalid, type, offset+position+first(mask)};
+        }
+    }
+#endif
+    
+    for (; position<size; position+=4) {
+        std::uint32_t group{0};
+        
+        const auto count=std::min<std::size_t>(4, size-position);
+        
+        for (std::size_t index{0}; index<4; ++index) {
+            std::uint8_t sextet{0};
+            
+            if (index<count) {
+                sextet=sextets[static_cast<unsigned char>(
+                    value[position+index])];
+            }
+            
+            if (sextet==invalid) {
+                return {outcome::invalid, type, offset+position+index};
+            }
+            
+            group=group<<6|sextet;
+        }
+        
+        for (std::size_t index{0}; index+1<count; ++index) {
+            *output++=static_cast<std::byte>(group>>(16-8*index));
+        }
+    }
+    
+    return {outcome::success, type};
+}
+
+}
+
+cast_result decode(std::string_view value, encoding type,
+    std::vector<std::byte>& result)
+{
+    constexpr std::string_view prefixes[]{"@hex:", "@b64:"};
+    
+    const auto& prefix=prefixes[static_cast<int>(type)];
+    const auto offset=value.substr(0, prefix.size())==prefix ?
+        prefix.size() : 0;
+    
+    return type==encoding::hexadecimal ?
+        hexadecimal(value.substr(offset), offset, result) :
+        base64(value.substr(offset), offset, result);
+}
+
+cast_result caster<std::vector<std::byte>>::apply(std::string_view value,
+    std::vector<std::byte>& result)
+{
+    return decode(value, value.substr(0, 5)=="@b64:" ? encoding::base64 :
+        encoding::hexadecimal, result);
+}
+
+}
@@ -0,0 +1,202 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cyra/argument.hh>
+#include <cyra/batch.hh>
+#include <cyra/cache.hh>
+#include <cyra/container.hh>
+#include <cyra/schema.hh>
+
+#include <utility>
+
+namespace cyra {
+
+cache::cache(std::size_t capacity)
+    : m_capacity{capacity}
+{
+}
+
+std::size_t cache::capacity() const noexcept
+{
+    return m_capacity;
+}
+
+std::size_t cache::size() const noexcept
+{
+    return m_entries.size();
+}
+
+std::size_t cache::hits() const noexcept
+{
+    return m_hits;
+}
+
+std::size_t cache::misses() const noexcept
+{
+    return m_misses;
+}
+
+void cache::clear()
+{
+    m_index.clear();
+    m_entries.clear();
+}
+
+bool cache::restore(const std::string& key, range& root)
+{
+    const auto match=m_index.find(key);
+    
+    if (match==m_index.end()) {
+        ++m_misses;
+        return false;
+    }
+    
+    const auto& source=*match->second;
+    
+    if (std::size_t position{0}, command{0};
+        !apply(root, source, position, command, false) ||
+        position!=source.states.size()) { // other commands or arguments
+        m_entries.erase(match->second);
+        m_index.erase(match);
+        
+        ++m_misses;
+        return false;
+    }
+    
+    std::size_t position{0}, command{0};
+    
+    reset(root); // including commands not given this time
+    apply(root, source, position, command, true);
+    
+    m_entries.splice(m_entries.begin(), m_entries, match->second);
+    
+    ++m_hits;
+    return true;
+}
+
+void cache::store(std::string key, const range& root)
+{
+    if (m_capacity==0 || m_index.count(key)) {
+        return;
+    }
+    
+    entry result{std::move(key), {}, {}};
+    
+    if (!capture(root, result)) {
+        return;
+    }
+    
+    if (m_entries.size()==m_capacity) {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+    }
+    
+    m_entries.push_front(std::move(result));
+    m_index.emplace(m_entries.front().key, m_entries.begin());
+}
+
+bool cache::capture(const range& scope, entry& output)
+{
+    for (argument& object:scope) {
+        if (const auto entry=dynamic_cast<const option*>(&object);
+            entry && entry->variable()) {
+            return false; // depends on the environment
+        }
+        
+        state current{&typeid(object), object.count().value(), {}};
+        
+        if (const auto storage=dynamic_cast<const tray*>(&object);
+            storage && current.count>0) {
+            current.values=storage->snapshot();
+            
+            if (!current.values.has_value()) {
+                return false;
+            }
+        }
+        
+        output.states.push_back(std::move(current));
+        
+        if (object && object.type()==argument::category::command) {
+            const auto next=dynamic_cast<const range*>(&object);
+            
+            if (!next) {
+                return false;
+            }
+            
+            output.schemas.push_back(next->index().fingerprint());
+            
+            if (!capture(*next, output)) {
+                return false;
+            }
+        }
+    }
+    
+    return true;
+}
+
+bool cache::apply(range& scope, const entry& source,
+    std::size_t& position, std::size_t& command, bool write)
+{
+    for (argument& object:scope) {
+        if (position==source.states.size()) {
+            return false;
+        }
+        
+        const auto& current=source.states[position++];
+        
+        if (*current.type!=typeid(object)) {
+            return false;
+        }
+        
+        if (write) {
+            object.count()+=current.count;
+            
+            if (current.values.has_value()) {
+                dynamic_cast<tray&>(object).restore(current.values);
+            }
+        }
+        
+        if (current.count>0 && object.type()==argument::category::command) {
+            const auto next=dynamic_cast<range*>(&object);
+            
+            if (!next || command==source.schemas.size()) {
+                return false;
+            }
+            
+            if (!write) { // entered, as a parse would
+                if (const auto scope=dynamic_cast<cyra::command*>(&object);
+                    scope) {
+                    scope->populate();
+                }
+                
+                if (next->index().fingerprint()!=source.schemas[command]) {
+                    return false;
+                }
+            }
+            
+            ++command;
+            
+            if (!apply(*next, source, position, command, write)) {
+                return false;
+            }
+        }
+    }
+    
+    return true;
+}
+
+}
@@ -20,224 +20,643 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
-#include <stdexcept>
 #include <type_traits>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#   include <immintrin.h>
+#   define CYRA_CAST_VECTOR
+#endif
+
 namespace cyra {
 
+cast_result::operator bool() const noexcept
+{
+    return status==outcome::success;
+}
+
+void cast_result::check(std::string_view value) const
+{
+    if (status==outcome::invalid && position!=std::string::npos) {
+        throw invalid_type{std::string{value}, type, position};
+    }
+    
+    if (status==outcome::invalid) {
+        throw invalid_type{std::string{value}, type};
+    }
+    
+    if (status==outcome::range) {
+        throw range_error{std::string{value}+" out of range of "+type};
+    }
+    
+    if (status==outcome::underflow) {
+        throw range_underflow{std::string{value}, type};
+    }
+    
+    if (status==outcome::overflow) {
+        throw range_overflow{std::string{value}, type};
+    }
+}
+
 namespace {
 
-std::string lower(std::string value)
+bool equal(std::string_view value, std::string_view choice) // ignoring case
 {
-    std::transform(value.begin(),
-        value.end(), value.begin(), [](unsigned char character) {
-        return std::tolower(character);
+    return std::equal(value.begin(), value.end(), choice.begin(), choice.end(),
+        [](unsigned char left, unsigned char right) {
+        return std::tolower(left)==std::tolower(right);
     });
-    
-    return value;
 }
 
 }
 
-template<>
-bool cast(const std::string& value)
+cast_result convert(std::string_view value, bool& result)
 {
     for (auto choice:{"1", "true", "yes", "on"}) {
-        if (lower(value)==choice) {
-            return true;
+        if (equal(value, choice)) {
+            result=true;
+            
+            return {};
         }
     }
     
     for (auto choice:{"0", "false", "no", "off"}) {
-        if (lower(value)==choice) {
-            return false;
+        if (equal(value, choice)) {
+            result=false;
+            
+            return {};
         }
     }
     
-    throw invalid_type{value, "a boolean"};
+    return {cast_result::outcome::invalid, "a boolean"};
 }
 
-template<>
-char cast(const std::string& value)
+cast_result convert(std::string_view value, char& result)
 {
     if (value.size()!=1) {
-        throw invalid_type{value, "a character"};
+        return {cast_result::outcome::invalid, "a character"};
     }
     
-    return value.front();
+    result=value.front();
+    
+    return {};
 }
 
 namespace {
 
-template<typename Function>
-auto forward(const std::string& value, const Function& converter)
+using outcome=cast_result::outcome;
+
+// accept what the strto* family accepts: leading white space and one sign
+
+const char* skip(const char* first, const char* last)
 {
-    std::size_t count{0};
-    
-    if (auto result=converter(value, count); count==value.size()) {
-        return result;
+    while (first!=last && std::isspace(static_cast<unsigned char>(*first))) {
+        ++first;
     }
     
-    throw std::invalid_argument{""};
+    return first;
 }
 
-template<typename Output>
-Output extract(const std::string& value);
-
-template<>
-long long extract(const std::string& value)
+outcome finish(std::from_chars_result result, const char* last)
 {
-    return forward(value, [](auto& value, auto& count) {
-        return std::stoll(value, &count);
-    });
+    if (result.ec==std::errc::result_out_of_range) {
+        return outcome::range;
+    }
+    
+    return result.ec==std::errc{} && result.ptr==last ? outcome::success :
+        outcome::invalid;
 }
 
-template<>
-unsigned long long extract(const std::string& value)
+#ifdef __cpp_lib_to_chars
+
+template<typename Output>
+outcome fractional(const char* first, const char* last, Output& result)
 {
-    auto result=forward(value, [](auto& value, auto& count) {
-        return std::stoull(value, &count);
-    });
+    auto format=std::chars_format::general;
     
-    if (!value.empty() && value.front()=='-') {
-        throw std::out_of_range{""};
+    if (last-first>2 && first[0]=='0' && (first[1]=='x' || first[1]=='X')) {
+        format=std::chars_format::hex;
+        first+=2;
     }
     
-    return result;
+    return finish(std::from_chars(first, last, result, format), last);
 }
 
-template<>
-float extract(const std::string& value)
-{
-    return forward(value, [](auto& value, auto& count) {
-        return std::stof(value, &count);
-    });
-}
+#else // no floating-point from_chars, as in libc++
 
-template<>
-double extract(const std::string& value)
+template<typename Output>
+outcome fractional(const char* first, const char* last, Output& result)
 {
-    return forward(value, [](auto& value, auto& count) {
-        return std::stod(value, &count);
-    });
+    if (first==last || std::isspace(static_cast<unsigned char>(*first)) ||
+        *first=='+' || *first=='-') {
+        return outcome::invalid; // strto* would skip these once more
+    }
+    
+    const std::string value(first, last); // strto* needs a terminator
+    char* end{nullptr};
+    
+    errno=0;
+    
+    if constexpr (std::is_same_v<Output, float>) {
+        result=std::strtof(value.c_str(), &end);
+    } else if constexpr (std::is_same_v<Output, double>) {
+        result=std::strtod(value.c_str(), &end);
+    } else {
+        result=std::strtold(value.c_str(), &end);
+    }
+    
+    if (end!=value.c_str()+value.size()) {
+        return outcome::invalid;
+    }
+    
+    return errno==ERANGE ? outcome::range : outcome::success;
 }
 
-template<>
-long double extract(const std::string& value)
+#endif
+
+template<typename Output>
+outcome extract(std::string_view value, Output& result)
 {
-    return forward(value, [](auto& value, auto& count) {
-        return std::stold(value, &count);
-    });
+    auto first=skip(value.data(), value.data()+value.size());
+    auto last=value.data()+value.size();
+    
+    bool negative{false};
+    
+    if (first!=last && (*first=='+' || *first=='-')) {
+        negative=*first++=='-';
+        
+        if (first!=last && (*first=='+' || *first=='-')) {
+            return outcome::invalid;
+        }
+    }
+    
+    if constexpr (std::is_integral_v<Output>) {
+        if constexpr (std::is_signed_v<Output>) {
+            first-=negative; // let from_chars see the minus sign
+        }
+        
+        auto status=finish(std::from_chars(first, last, result), last);
+        
+        if (std::is_unsigned_v<Output> && negative) {
+            status=status==outcome::success ? outcome::range : status;
+        }
+        
+        return status;
+    } else {
+        auto status=fractional(first, last, result);
+        
+        if (negative) {
+            result=-result;
+        }
+        
+        return status;
+    }
 }
 
 template<typename Input, typename Output>
-Output narrow(Input value)
+outcome narrow(Input value, Output& result)
 {
     if (value<std::numeric_limits<Output>::min()) {
-        throw std::underflow_error{""};
+        return outcome::underflow;
     }
     
     if (value>std::numeric_limits<Output>::max()) {
-        throw std::overflow_error{""};
+        return outcome::overflow;
     }
     
-    return value;
+    result=static_cast<Output>(value);
+    
+    return outcome::success;
 }
 
 template<typename Output>
-Output convert(const std::string& type, const std::string& value)
+cast_result integral(std::string_view value, Output& result)
 {
-    Output result{};
+    using input=std::conditional_t<std::is_signed_v<Output>,
+        long long, unsigned long long>;
+    
+    input intermediate{};
     
-    try {
-        if constexpr (std::is_integral_v<Output>) {
-            using input=std::conditional_t<std::is_signed_v<Output>,
-                long long, unsigned long long>;
+    if (auto status=extract(value, intermediate); status!=outcome::success) {
+        return {status, "an integer"};
+    }
+    
+    return {narrow(intermediate, result), "an integer"};
+}
+
+template<typename Output>
+cast_result floating(std::string_view value, Output& result)
+{
+    return {extract(value, result), "a floating-point integer"};
+}
+
+}
+
+cast_result convert(std::string_view value, short& result)
+{
+    return integral(value, result);
+}
+
+cast_result convert(std::string_view value, unsigned short& result)
+{
+    return integral(value, result);
+}
+
+cast_result convert(std::string_view value, int& result)
+{
+    return integral(value, result);
+}
+
+cast_result convert(std::string_view value, unsigned int& result)
+{
+    return integral(value, result);
+}
+
+cast_result convert(std::string_view value, long& result)
+{
+    return integral(value, result);
+}
+
+cast_result convert(std::string_view value, unsigned long& result)
+{
+    return integral(value, result);
+}
+
+cast_result convert(std::string_view value, long long& result)
+{
+    return integral(value, result);
+}
+
+cast_result convert(std::string_view value, unsigned long long& result)
+{
+    return integral(value, result);
+}
+
+cast_result convert(std::string_view value, float& result)
+{
+    return floating(value, result);
+}
+
+cast_result convert(std::string_view value, double& result)
+{
+    return floating(value, result);
+}
+
+cast_result convert(std::string_view value, long double& result)
+{
+    return floating(value, result);
+}
+
+cast_result convert(std::string_view value, std::string& result)
+{
+    result.assign(value.begin(), value.end());
+    
+    return {};
+}
+
+namespace {
+
+#ifdef CYRA_CAST_VECTOR
+
+using detector=std::uint64_t (*)(const char* data, char delimiter);
+
+std::uint64_t detect(const char* data, char delimiter) // 64 bytes, SSE2
+{
+    const auto needle=_mm_set1_epi8(delimiter);
+    std::uint64_t mask{0};
+    
+    for (int offset{0}; offset<64; offset+=16) {
+        auto block=_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(data+offset));
+        
+        mask|=std::uint64_t(std::uint16_t(_mm_movemask_epi8(
+            _mm_cmpeq_epi8(block, needle))))<<offset;
+    }
+    
+    return mask;
+}
+
+__attribute__((target("avx2")))
+std::uint64_t broad(const char* data, char delimiter) // 64 bytes, AVX2
+{
+    const auto needle=_mm256_set1_epi8(delimiter);
+    
+    auto lower=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    auto upper=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data+32));
+    
+    return std::uint64_t(std::uint32_t(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(lower, needle))))|
+        std::uint64_t(std::uint32_t(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(upper, needle))))<<32;
+}
+
+detector select()
+{
+    __builtin_cpu_init();
+    
+    return __builtin_cpu_supports("avx2") ? broad : detect;
+}
+
+#endif
+
+template<typename Function>
+void separate(const std::string& value, char delimiter, Function&& consume)
+{
+    const char* data=value.data();
+    std::size_t first{0}, position{0};
+    
+#ifdef CYRA_CAST_VECTOR
+    static const detector scan=select();
+    
+    for (; position+64<=value.size(); position+=64) {
+        for (auto mask=scan(data+position, delimiter); mask; mask&=mask-1) {
+            const auto last=position+__builtin_ctzll(mask);
             
-            result=narrow<input, Output>(extract<input>(value));
-        } else if (std::is_floating_point_v<Output>) {
-            result=extract<Output>(value);
+            consume(data+first, data+last);
+            first=last+1;
         }
-    } catch (const std::invalid_argument& error) {
-        throw invalid_type{value, type};
-    } catch (const std::out_of_range& error) {
-        throw range_error{value+" out of range of "+type};
-    } catch (const std::underflow_error& error) {
-        throw range_underflow{value, type};
-    } catch (const std::overflow_error& error) {
-        throw range_overflow{value, type};
     }
+#endif
+    
+    for (; position<value.size(); ++position) {
+        if (data[position]==delimiter) {
+            consume(data+first, data+position);
+            first=position+1;
+        }
+    }
+    
+    consume(data+first, data+value.size());
+}
+
+#if __BYTE_ORDER__==__ORDER_LITTLE_ENDIAN__
+
+bool digits(std::uint64_t chunk) // eight ASCII digits
+{
+    return ((chunk&0xF0F0F0F0F0F0F0F0)|
+        ((chunk+0x0606060606060606)&0xF0F0F0F0F0F0F0F0)>>4)==
+        (0x3030303030303030|0x0303030303030303);
+}
+
+std::uint64_t fold(std::uint64_t chunk) // eight ASCII digits to a number
+{
+    chunk-=0x3030303030303030;
+    chunk=(chunk*10+(chunk>>8))&0x00FF00FF00FF00FF;
+    chunk=(chunk*100+(chunk>>16))&0x0000FFFF0000FFFF;
     
-    return result;
+    return (chunk*10000+(chunk>>32))&0xFFFFFFFF;
 }
 
+#endif
+
+template<typename Type>
+bool integer(const char* first, const char* last, Type& result)
+{
+    constexpr auto limit=std::numeric_limits<unsigned long long>::max();
+    
+    bool negative{false};
+    
+    if (first!=last && (*first=='-' || *first=='+')) {
+        negative=*first++=='-';
+    }
+    
+    if (first==last || (negative && std::is_unsigned_v<Type>)) {
+        return false;
+    }
+    
+    unsigned long long magnitude{0};
+    
+#if __BYTE_ORDER__==__ORDER_LITTLE_ENDIAN__
+    for (std::uint64_t chunk; last-first>=8; first+=8) {
+        if (std::memcpy(&chunk, first, 8); !digits(chunk)) {
+            break;
+        }
+        
+        if (const auto part=fold(chunk); magnitude>(limit-part)/100000000) {
+            return false;
+        } else {
+            magnitude=magnitude*100000000+part;
+        }
+    }
+#endif
+    
+    for (; first!=last; ++first) {
+        const unsigned digit=static_cast<unsigned char>(*first)-'0';
+        
+        if (digit>9 || magnitude>(limit-digit)/10) {
+            return false;
+        }
+        
+        magnitude=magnitude*10+digit;
+    }
+    
+    using bound=std::numeric_limits<Type>;
+    
+    if (negative) {
+        if (magnitude>0ull-static_cast<unsigned long long>(bound::min())) {
+            return false;
+        }
+        
+        result=static_cast<Type>(0ull-magnitude);
+    } else {
+        if (magnitude>static_cast<unsigned long long>(bound::max())) {
+            return false;
+        }
+        
+        result=static_cast<Type>(magnitude);
+    }
+    
+    return true;
+}
+
+template<typename Type>
+bool real(const char* first, const char* last, Type& result)
+{
+    // exact powers of ten; a mantissa and power both exactly representable
+    // give a correctly rounded product or quotient
+    
+    constexpr Type powers[]{1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+        1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+        1e20, 1e21, 1e22};
+    
+    constexpr int exact{std::is_same_v<Type, float> ? 10 : 22};
+    constexpr auto mantissa=1ull<<std::numeric_limits<Type>::digits;
+    
+    bool negative{false};
+    
+    if (first!=last && (*first=='-' || *first=='+')) {
+        negative=*first++=='-';
+    }
+    
+    unsigned long long significand{0};
+    int count{0}, exponent{0};
+    
+    for (; first!=last && unsigned(*first-'0')<=9; ++first, ++count) {
+        significand=significand*10+unsigned(*first-'0');
+    }
+    
+    if (first!=last && *first=='.') {
+        for (++first; first!=last && unsigned(*first-'0')<=9; ++first) {
+            significand=significand*10+unsigned(*first-'0');
+            ++count;
+            --exponent;
+        }
+    }
+    
+    if (count==0 || count>19) {
+        return false;
+    }
+    
+    if (first!=last && (*first=='e' || *first=='E')) {
+        bool minus{false};
+        int power{0};
+        
+        if (++first!=last && (*first=='-' || *first=='+')) {
+            minus=*first++=='-';
+        }
+        
+        if (first==last) {
+            return false;
+        }
+        
+        for (; first!=last && unsigned(*first-'0')<=9; ++first) {
+            if ((power=power*10+(*first-'0'))>exact*4) {
+                return false;
+            }
+        }
+        
+        exponent+=minus ? -power : power;
+    }
+    
+    if (first!=last || significand>mantissa || exponent<-exact ||
+        exponent>exact) {
+        return false;
+    }
+    
+    result=static_cast<Type>(significand);
+    result=exponent<0 ? result/powers[-exponent] : result*powers[exponent];
+    result=negative ? -result : result;
+    
+    return true;
+}
+
+template<typename Type>
+void gather(const std::string& value, char delimiter,
+    std::vector<Type>& output)
+{
+    separate(value, delimiter, [&](const char* first, const char* last) {
+        if constexpr (std::is_same_v<Type, std::string>) {
+            output.emplace_back(first, last);
+        } else {
+            Type result{};
+            bool fast{false};
+            
+            if constexpr (std::is_integral_v<Type>) {
+                fast=integer(first, last, result);
+            } else if constexpr (!std::is_same_v<Type, long double>) {
+                fast=real(first, last, result);
+            }
+            
+            // anything beyond plain digits, as well as every failure, takes
+            // the scalar path to keep its syntax and exceptions
+            
+            if (const std::string_view element(first, last-first); !fast) {
+                convert(element, result).check(element);
+            }
+            
+            output.push_back(result);
+        }
+    });
+}
+
+}
+
+template<>
+void cast(const std::string& value, char delimiter,
+    std::vector<short>& output)
+{
+    gather(value, delimiter, output);
 }
 
 template<>
-short cast(const std::string& value)
+void cast(const std::string& value, char delimiter,
+    std::vector<unsigned short>& output)
 {
-    return convert<short>("an integer", value);
+    gather(value, delimiter, output);
 }
 
 template<>
-unsigned short cast(const std::string& value)
+void cast(const std::string& value, char delimiter,
+    std::vector<int>& output)
 {
-    return convert<unsigned short>("an integer", value);
+    gather(value, delimiter, output);
 }
 
 template<>
-int cast(const std::string& value)
+void cast(const std::string& value, char delimiter,
+    std::vector<unsigned int>& output)
 {
-    return convert<int>("an integer", value);
+    gather(value, delimiter, output);
 }
 
 template<>
-unsigned int cast(const std::string& value)
+void cast(const std::string& value, char delimiter,
+    std::vector<long>& output)
 {
-    return convert<unsigned int>("an integer", value);
+    gather(value, delimiter, output);
 }
 
 template<>
-long cast(const std::string& value)
+void cast(const std::string& value, char delimiter,
+    std::vector<unsigned long>& output)
 {
-    return convert<long>("an integer", value);
+    gather(value, delimiter, output);
 }
 
 template<>
-unsigned long cast(const std::string& value)
+void cast(const std::string& value, char delimiter,
+    std::vector<long long>& output)
 {
-    return convert<unsigned long>("an integer", value);
+    gather(value, delimiter, output);
 }
 
 template<>
-long long cast(const std::string& value)
+void cast(const std::string& value, char delimiter,
+    std::vector<unsigned long long>& output)
 {
-    return convert<long long>("an integer", value);
+    gather(value, delimiter, output);
 }
 
 template<>
-unsigned long long cast(const std::string& value)
+void cast(const std::string& value, char delimiter,
+    std::vector<float>& output)
 {
-    return convert<unsigned long long>("an integer", value);
+    gather(value, delimiter, output);
 }
 
 template<>
-float cast(const std::string& value)
+void cast(const std::string& value, char delimiter,
+    std::vector<double>& output)
 {
-    return convert<float>("a floating-point integer", value);
+    gather(value, delimiter, output);
 }
 
 template<>
-double cast(const std::string& value)
+void cast(const std::string& value, char delimiter,
+    std::vector<long double>& output)
 {
-    return convert<double>("a floating-point integer", value);
+    gather(value, delimiter, output);
 }
 
 template<>
-long double cast(const std::string& value)
+void cast(const std::string& value, char delimiter,
+    std::vector<std::string>& output)
 {
-    return convert<long double>("a floating-point integer", value);
+    gather(value, delimiter, output);
 }
 
 }
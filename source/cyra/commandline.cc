@@ -16,14 +16,86 @@
 */
 
 #include <cyra/commandline.hh>
+#include <cyra/exception.hh>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <utility>
-#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#   include <emmintrin.h>
+#   define CYRA_COMMANDLINE_VECTOR
+#endif
 
 namespace cyra {
 
 commandline::commandline(int count, const char* const* values)
-    : commandline{std::vector<std::string>{values, count+values}}
+{
+    for (int index{0}; index<count; ++index) {
+        push(values[index]);
+    }
+    
+    start();
+}
+
+commandline::commandline(std::string line, shell)
+    : m_source{std::make_shared<const std::string>(std::move(line))}
+{
+    tokenize();
+    start();
+}
+
+commandline::commandline(std::string buffer, separated)
+    : m_source{std::make_shared<const std::string>(std::move(buffer))}
+{
+    split();
+    start();
+}
+
+namespace {
+
+std::string read(int descriptor)
+{
+    std::string buffer;
+    std::size_t size{0};
+    
+    if (struct stat status; ::fstat(descriptor, &status)==0 &&
+        S_ISREG(status.st_mode)) { // procfs reports zero, pipes nothing
+        buffer.resize(static_cast<std::size_t>(status.st_size)+1);
+    }
+    
+    while (true) {
+        if (size==buffer.size()) {
+            buffer.resize(std::max<std::size_t>(4096, buffer.size()*2));
+        }
+        
+        const auto count=::read(descriptor, buffer.data()+size,
+            buffer.size()-size);
+        
+        if (count<0 && errno!=EINTR) {
+            throw file_error{"descriptor "+std::to_string(descriptor),
+                std::strerror(errno)};
+        }
+        
+        if (count==0) {
+            break;
+        }
+        
+        size+=static_cast<std::size_t>(std::max<decltype(count)>(count, 0));
+    }
+    
+    buffer.resize(size);
+    return buffer;
+}
+
+}
+
+commandline::commandline(int descriptor, separated syntax)
+    : commandline{read(descriptor), syntax}
 {
 }
 
@@ -42,4 +114,191 @@ const std::string& commandline::path() const noexcept
     return m_path;
 }
 
+void commandline::push(std::string_view argument)
+{
+    if (!m_pool) {
+        m_pool=std::make_shared<list<pooled>>();
+    }
+    
+    m_pool->push(argument);
+    m_arguments.push_back(m_pool->back());
+}
+
+void commandline::start()
+{
+    if (m_arguments.empty()) {
+        throw initialization_error{"no arguments supplied to commandline"};
+    }
+    
+    m_path=m_arguments.front();
+    m_next=1;
+}
+
+namespace {
+
+constexpr bool blank(char character) noexcept
+{
+    return character==' ' || character=='\t' || character=='\n';
+}
+
+constexpr bool special(char character) noexcept
+{
+    return blank(character) ||
+        character=='\'' || character=='"' || character=='\\';
+}
+
+std::size_t plain(const char* data, std::size_t size) noexcept
+{
+    // length of the leading run without blanks, quotes and backslashes
+    
+    std::size_t index{0};
+    
+#ifdef CYRA_COMMANDLINE_VECTOR
+    const auto space=_mm_set1_epi8(' ');
+    const auto tab=_mm_set1_epi8('\t');
+    const auto newline=_mm_set1_epi8('\n');
+    const auto single=_mm_set1_epi8('\'');
+    const auto twin=_mm_set1_epi8('"');
+    const auto backslash=_mm_set1_epi8('\\');
+    
+    for (; index+16<=size; index+=16) {
+        const auto block=_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(data+index));
+        
+        const auto blanks=_mm_or_si128(_mm_cmpeq_epi8(block, space),
+            _mm_or_si128(_mm_cmpeq_epi8(block, tab),
+            _mm_cmpeq_epi8(block, newline)));
+        const auto quotes=_mm_or_si128(_mm_cmpeq_epi8(block, single),
+            _mm_or_si128(_mm_cmpeq_epi8(block, twin),
+            _mm_cmpeq_epi8(block, backslash)));
+        
+        if (const auto mask=_mm_movemask_epi8(_mm_or_si128(blanks, quotes));
+            mask!=0) {
+            return index+__builtin_ctz(static_cast<unsigned>(mask));
+        }
+    }
+#endif
+    
+    while (index<size && !special(data[index])) {
+        ++index;
+    }
+    
+    return index;
+}
+
+}
+
+void commandline::tokenize()
+{
+    const std::string_view text{*m_source};
+    
+    std::string word; // reused for tokens that need unescaping
+    std::size_t position{0};
+    
+    while (true) {
+        while (position<text.size() && blank(text[position])) {
+            ++position;
+        }
+        
+        if (position==text.size()) {
+            return;
+        }
+        
+        const auto first=position;
+        position+=plain(text.data()+position, text.size()-position);
+        
+        if (position==text.size() || blank(text[position])) {
+            m_arguments.push_back(text.substr(first, position-first));
+            continue;
+        }
+        
+        word.assign(text.substr(first, position-first));
+        bool present{position>first}; // a quoted empty string is a token
+        
+        while (position<text.size() && !blank(text[position])) {
+            const auto opening=position;
+            
+            if (text[position]=='\'') {
+                const auto closing=text.find('\'', position+1);
+                
+                if (closing==text.npos) {
+                    throw unterminated_quote{'\'', opening};
+                }
+                
+                word.append(text.substr(position+1, closing-position-1));
+                position=closing+1;
+                present=true;
+            } else if (text[position]=='"') {
+                for (++position; ; ) {
+                    const auto next=text.find_first_of("\"\\", position);
+                    
+                    if (next==text.npos) {
+                        throw unterminated_quote{'"', opening};
+                    }
+                    
+                    word.append(text.substr(position, next-position));
+                    position=next+1;
+                    
+                    if (text[next]=='"') {
+                        break;
+                    }
+                    
+                    if (position==text.size()) {
+                        throw unterminated_quote{'"', opening};
+                    }
+                    
+                    // within double quotes only these are escaped
+                    if (const auto escaped=text[position];
+                        std::string_view{"$`\"\\"}.find(escaped)!=text.npos) {
+                        word.push_back(escaped);
+                        ++position;
+                    } else if (escaped=='\n') {
+                        ++position;
+                    } else {
+                        word.push_back('\\');
+                    }
+                }
+                
+                present=true;
+            } else if (text[position]=='\\') {
+                if (position+1==text.size()) {
+                    throw unterminated_quote{'\\', opening};
+                }
+                
+                if (text[position+1]!='\n') { // otherwise a continuation
+                    word.push_back(text[position+1]);
+                    present=true;
+                }
+                
+                position+=2;
+            }
+            
+            const auto run=plain(text.data()+position, text.size()-position);
+            
+            word.append(text.substr(position, run));
+            present=present || run>0;
+            position+=run;
+        }
+        
+        if (present) {
+            push(word);
+        }
+    }
+}
+
+void commandline::split()
+{
+    // a trailing NUL ends the last argument rather than starting another
+    
+    for (std::string_view rest{*m_source}; !rest.empty(); ) {
+        const auto end=static_cast<const char*>(
+            std::memchr(rest.data(), '\0', rest.size()));
+        const auto length=end ? static_cast<std::size_t>(end-rest.data()) :
+            rest.size();
+        
+        m_arguments.push_back(rest.substr(0, length));
+        rest.remove_prefix(end ? length+1 : length);
+    }
+}
+
 }
@@ -0,0 +1,376 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cyra/argument.hh>
+#include <cyra/completion.hh>
+#include <cyra/container.hh>
+#include <cyra/exception.hh>
+#include <cyra/schema.hh>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cyra {
+
+/*  The index is one flat buffer in native byte order, so that it can be
+    mapped from a file as it is:
+    
+    header   "cyra", version, scope count, entry count, pool size (5 x 32 bit)
+    scopes   first entry, entry count (2 x 32 bit each)
+    entries  pool offset, key length, child scope (3 x 32 bit), category,
+             value flag (2 x 8 bit), padding (16 bit)
+    pool     key characters
+    
+    Entries of a scope are sorted by key, the root scope comes first. */
+
+namespace {
+
+constexpr std::uint32_t version{1};
+constexpr std::uint32_t none{std::numeric_limits<std::uint32_t>::max()};
+
+constexpr std::size_t header_size{20};
+constexpr std::size_t scope_size{8};
+constexpr std::size_t entry_size{16};
+
+template<typename Type>
+Type read(const char* data, std::size_t offset) noexcept
+{
+    Type result;
+    std::memcpy(&result, data+offset, sizeof(result));
+    
+    return result;
+}
+
+template<typename Type>
+void write(std::vector<char>& data, Type value)
+{
+    const auto bytes=reinterpret_cast<const char*>(&value);
+    data.insert(data.end(), bytes, bytes+sizeof(value));
+}
+
+class builder {
+public:
+    struct entry {
+        std::string key;
+        
+        std::uint32_t child;
+        std::uint8_t type;
+        std::uint8_t value;
+    };
+    
+    std::vector<std::vector<entry>> scopes;
+    
+    std::uint32_t visit(range& scope)
+    {
+        if (const auto match=m_visited.find(&scope); match!=m_visited.end()) {
+            return match->second;
+        }
+        
+        const auto result=static_cast<std::uint32_t>(scopes.size());
+        
+        scopes.emplace_back();
+        m_visited.emplace(&scope, result);
+        
+        std::vector<entry> entries;
+        
+        const auto& index=scope.index();
+        
+        for (std::size_t position{0}; position<index.keys(); ++position) {
+            argument& object=index.object(index.owner(position));
+            
+            entries.push_back({std::string{index.key(position)}, none,
+                static_cast<std::uint8_t>(object.type()), 0});
+            
+            if (object.type()==argument::category::option) {
+                entries.back().value=(dynamic_cast<tray*>(&object) &&
+                    object.count().minimum()>0);
+            } else if (object.type()==argument::category::command) {
+                if (const auto next=dynamic_cast<command*>(&object); next) {
+                    next->populate();
+                }
+                
+                if (const auto next=dynamic_cast<range*>(&object); next) {
+                    entries.back().child=visit(*next);
+                }
+            }
+        }
+        
+        scopes[result]=std::move(entries);
+        return result;
+    }
+    
+private:
+    std::unordered_map<const range*, std::uint32_t> m_visited;
+};
+
+}
+
+completion::completion(range& root)
+{
+    builder tree;
+    tree.visit(root);
+    
+    std::vector<char> scopes;
+    std::vector<char> entries;
+    std::string pool;
+    
+    std::uint32_t count{0};
+    
+    for (const auto& scope:tree.scopes) {
+        write(scopes, count);
+        write(scopes, static_cast<std::uint32_t>(scope.size()));
+        
+        for (const auto& item:scope) {
+            write(entries, static_cast<std::uint32_t>(pool.size()));
+            write(entries, static_cast<std::uint32_t>(item.key.size()));
+            write(entries, item.child);
+            write(entries, item.type);
+            write(entries, item.value);
+            write(entries, std::uint16_t{0});
+            
+            pool+=item.key;
+        }
+        
+        count+=static_cast<std::uint32_t>(scope.size());
+    }
+    
+    auto data=std::make_shared<std::vector<char>>();
+    data->insert(data->end(), {'c', 'y', 'r', 'a'});
+    
+    write(*data, version);
+    write(*data, static_cast<std::uint32_t>(tree.scopes.size()));
+    write(*data, count);
+    write(*data, static_cast<std::uint32_t>(pool.size()));
+    
+    data->insert(data->end(), scopes.begin(), scopes.end());
+    data->insert(data->end(), entries.begin(), entries.end());
+    data->insert(data->end(), pool.begin(), pool.end());
+    
+    m_size=data->size();
+    m_data=std::shared_ptr<const char>{data, data->data()};
+    
+    load();
+}
+
+completion::completion(const std::string& path)
+{
+    const auto descriptor=::open(path.c_str(), O_RDONLY|O_CLOEXEC);
+    
+    if (descriptor<0) {
+        throw file_error{path, std::strerror(errno)};
+    }
+    
+    struct stat status;
+    void* mapping{MAP_FAILED};
+    
+    if (::fstat(descriptor, &status)==0 && status.st_size>0) {
+        m_size=static_cast<std::size_t>(status.st_size);
+        mapping=::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    }
+    
+    const auto error=errno;
+    ::close(descriptor);
+    
+    if (mapping==MAP_FAILED) {
+        throw file_error{path,
+            (m_size==0) ? "empty file" : std::strerror(error)};
+    }
+    
+    m_data=std::shared_ptr<const char>{static_cast<const char*>(mapping),
+        [size=m_size](const char* data) {
+        ::munmap(const_cast<char*>(data), size);
+    }};
+    
+    try {
+        load();
+    } catch (const initialization_error& error) {
+        throw file_error{path, error.what()};
+    }
+}
+
+auto completion::operator()(const std::vector<std::string>& words) const
+    -> candidates
+{
+    std::uint32_t current{0};
+    
+    std::optional<std::string_view> pending;
+    bool operands{false};
+    
+    for (std::size_t index{0}; index+1<words.size(); ++index) {
+        const std::string_view word{words[index]};
+        
+        if (pending || operands) {
+            pending.reset();
+            continue;
+        }
+        
+        if (word=="--") {
+            operands=true;
+            continue;
+        }
+        
+        const auto name=word.substr(0, word.find('='));
+        const auto [first, last]=prefix(current, name);
+        
+        if (first==last || key(first)!=name) {
+            continue;
+        }
+        
+        const auto item=entry(first);
+        const auto type=static_cast<argument::category>(
+            read<std::uint8_t>(m_data.get(), item+12));
+        
+        if (type==argument::category::command) {
+            if (const auto child=read<std::uint32_t>(m_data.get(), item+8);
+                child!=none) {
+                current=child;
+            }
+        } else if (type==argument::category::option &&
+            read<std::uint8_t>(m_data.get(), item+13) && key(first)==word) {
+            pending=key(first);
+        }
+    }
+    
+    const auto word=words.empty() ? std::string_view{} :
+        std::string_view{words.back()}; // not a temporary string
+    
+    if (pending) {
+        return {category::value, std::string{pending.value()}, {}};
+    } else if (operands) {
+        return {category::operand, {}, {}};
+    } else if (word.substr(0, 2)=="--" && word.find('=')!=word.npos) {
+        const auto name=word.substr(0, word.find('='));
+        return {category::value, std::string{name}, {}};
+    }
+    
+    candidates result{category::argument, {}, {}};
+    
+    for (auto [first, last]=prefix(current, word); first<last; ++first) {
+        result.keys.emplace_back(key(first));
+    }
+    
+    return result;
+}
+
+void completion::save(const std::string& path) const
+{
+    std::ofstream file{path, std::ios::binary|std::ios::trunc};
+    
+    if (!file.write(m_data.get(), static_cast<std::streamsize>(m_size)) ||
+        !file.flush()) {
+        throw file_error{path, "unable to write completion index"};
+    }
+}
+
+std::size_t completion::scope(std::uint32_t index) const noexcept
+{
+    return header_size+index*scope_size;
+}
+
+std::size_t completion::entry(std::uint32_t index) const noexcept
+{
+    return header_size+m_scopes*scope_size+index*entry_size;
+}
+
+std::string_view completion::key(std::uint32_t index) const
+{
+    const auto pool=entry(m_entries);
+    const auto item=entry(index);
+    
+    return {m_data.get()+pool+read<std::uint32_t>(m_data.get(), item),
+        read<std::uint32_t>(m_data.get(), item+4)};
+}
+
+auto completion::prefix(std::uint32_t scope, std::string_view key) const
+    -> std::pair<std::uint32_t, std::uint32_t>
+{
+    auto first=read<std::uint32_t>(m_data.get(), this->scope(scope));
+    auto last=first+read<std::uint32_t>(m_data.get(), this->scope(scope)+4);
+    
+    while (first<last) {
+        const auto middle=first+(last-first)/2;
+        
+        if (this->key(middle)<key) {
+            first=middle+1;
+        } else {
+            last=middle;
+        }
+    }
+    
+    last=first;
+    
+    const auto end=read<std::uint32_t>(m_data.get(), this->scope(scope))+
+        read<std::uint32_t>(m_data.get(), this->scope(scope)+4);
+    
+    while (last<end && this->key(last).substr(0, key.size())==key) {
+        ++last;
+    }
+    
+    return {first, last};
+}
+
+// validates the buffer once, so that lookups can trust it
+void completion::load()
+{
+    if (m_size<header_size || std::memcmp(m_data.get(), "cyra", 4)!=0 ||
+        read<std::uint32_t>(m_data.get(), 4)!=version) {
+        throw initialization_error{"not a completion index"};
+    }
+    
+    m_scopes=read<std::uint32_t>(m_data.get(), 8);
+    m_entries=read<std::uint32_t>(m_data.get(), 12);
+    
+    const auto pool=read<std::uint32_t>(m_data.get(), 16);
+    
+    if (m_scopes==0 || m_size!=std::size_t{entry(m_entries)}+pool) {
+        throw initialization_error{"truncated completion index"};
+    }
+    
+    for (std::uint32_t index{0}; index<m_scopes; ++index) {
+        const auto base=m_data.get()+scope(index);
+        
+        const std::uint64_t first=read<std::uint32_t>(base, 0);
+        const auto count=read<std::uint32_t>(base, 4);
+        
+        if (first+count>m_entries) {
+            throw initialization_error{"corrupt completion index scope"};
+        }
+    }
+    
+    for (std::uint32_t index{0}; index<m_entries; ++index) {
+        const auto base=m_data.get()+entry(index);
+        
+        const std::uint64_t offset=read<std::uint32_t>(base, 0);
+        const auto length=read<std::uint32_t>(base, 4);
+        const auto child=read<std::uint32_t>(base, 8);
+        
+        if (offset+length>pool || (child!=none && child>=m_scopes)) {
+            throw initialization_error{"corrupt completion index entry"};
+        }
+    }
+}
+
+}
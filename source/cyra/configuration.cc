@@ -0,0 +1,184 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cyra/configuration.hh>
+#include <cyra/exception.hh>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cyra {
+
+configuration::configuration(const std::string& path)
+    : m_name{path}
+{
+    const auto descriptor=::open(path.c_str(), O_RDONLY|O_CLOEXEC);
+    
+    if (descriptor<0) {
+        throw file_error{path, std::strerror(errno)};
+    }
+    
+    struct stat status;
+    
+    if (::fstat(descriptor, &status)!=0) {
+        const auto error=errno;
+        ::close(descriptor);
+        
+        throw file_error{path, std::strerror(error)};
+    }
+    
+    m_size=static_cast<std::size_t>(status.st_size);
+    
+    if (m_size==0) { // nothing to map
+        ::close(descriptor);
+        return;
+    }
+    
+    const auto mapping=::mmap(nullptr, m_size,
+        PROT_READ, MAP_PRIVATE, descriptor, 0);
+    
+    const auto error=errno;
+    ::close(descriptor);
+    
+    if (mapping==MAP_FAILED) {
+        throw file_error{path, std::strerror(error)};
+    }
+    
+    m_data=std::shared_ptr<const char>{static_cast<const char*>(mapping),
+        [size=m_size](const char* data) {
+        ::munmap(const_cast<char*>(data), size);
+    }};
+    
+    ::madvise(mapping, m_size, MADV_SEQUENTIAL);
+    
+    tokenize();
+}
+
+configuration::configuration(std::string_view text, const std::string& name)
+    : m_data{std::shared_ptr<const char>{}, text.data()}, m_size{text.size()},
+      m_name{name}
+{
+    tokenize();
+}
+
+auto configuration::name() const noexcept -> const std::string&
+{
+    return m_name;
+}
+
+auto configuration::begin() const noexcept -> const_iterator
+{
+    return m_entries.begin();
+}
+
+auto configuration::end() const noexcept -> const_iterator
+{
+    return m_entries.end();
+}
+
+std::size_t configuration::size() const noexcept
+{
+    return m_entries.size();
+}
+
+namespace {
+
+constexpr bool blank(char character) noexcept
+{
+    return character==' ' || (character>='\t' && character<='\r');
+}
+
+std::string_view trim(std::string_view text) noexcept
+{
+    while (!text.empty() && blank(text.front())) {
+        text.remove_prefix(1);
+    }
+    
+    while (!text.empty() && blank(text.back())) {
+        text.remove_suffix(1);
+    }
+    
+    return text;
+}
+
+std::string_view unquote(std::string_view text) noexcept
+{
+    if (text.size()>=2 && (text.front()=='"' || text.front()=='\'') &&
+        text.back()==text.front()) {
+        return text.substr(1, text.size()-2);
+    }
+    
+    return text;
+}
+
+}
+
+void configuration::tokenize()
+{
+    std::string_view rest{m_data.get(), m_size};
+    std::string_view section;
+    
+    if (rest.substr(0, 3)=="\xEF\xBB\xBF") { // byte order mark
+        rest.remove_prefix(3);
+    }
+    
+    for (std::size_t line{1}; !rest.empty(); ++line) {
+        const auto end=static_cast<const char*>(
+            std::memchr(rest.data(), '\n', rest.size()));
+        const auto length=end ? static_cast<std::size_t>(end-rest.data()) :
+            rest.size();
+        
+        const auto text=trim(rest.substr(0, length));
+        rest.remove_prefix(end ? length+1 : length);
+        
+        if (text.empty() || text.front()=='#' || text.front()==';') {
+            continue;
+        }
+        
+        if (text.front()=='[') {
+            if (text.back()!=']') {
+                throw file_error{m_name,
+                    "unterminated section on line "+std::to_string(line)};
+            }
+            
+            section=trim(text.substr(1, text.size()-2));
+            continue;
+        }
+        
+        entry current{section, text, std::nullopt, line};
+        
+        if (const auto separator=text.find('='); separator!=text.npos) {
+            current.key=trim(text.substr(0, separator));
+            current.value=unquote(trim(text.substr(separator+1)));
+        }
+        
+        if (current.key.empty()) {
+            throw file_error{m_name,
+                "missing key on line "+std::to_string(line)};
+        }
+        
+        m_entries.push_back(current);
+    }
+}
+
+}
@@ -17,8 +17,13 @@
 
 #include <cyra/argument.hh>
 #include <cyra/container.hh>
+#include <cyra/exception.hh>
+#include <cyra/schema.hh>
 
 #include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
 
 namespace cyra {
 
@@ -30,10 +35,8 @@ auto range::operator[](const std::string& key) const
 
 auto range::query(const std::string& key) const -> std::optional<value_type>
 {
-    for (argument& object:*this) {
-        if (object.name().query(key)) {
-            return {object};
-        }
+    if (const auto position=index().find(key); position) {
+        return {index().object(position.value())};
     }
     
     return {};
@@ -41,10 +44,9 @@ auto range::query(const std::string& key) const -> std::optional<value_type>
 
 auto range::match(const std::string& key) const -> std::optional<value_type>
 {
-    for (argument& object:*this) {
-        if (object.name().match(key)) {
-            return {object};
-        }
+    if (auto result=query(key); result) {
+        result.value().get().name().match(key);
+        return result;
     }
     
     return {};
@@ -59,6 +61,7 @@ void range::attach(argument& object)
     }
     
     push_back(object);
+    m_index.reset();
 }
 
 void range::detach(const argument& object)
@@ -69,7 +72,272 @@ void range::detach(const argument& object)
     
     if (match!=end()) {
         erase(match);
+        m_index.reset();
+    }
+}
+
+void range::constrain(relation type,
+    std::vector<std::reference_wrapper<const argument>> objects)
+{
+    for (const argument& object:objects) {
+        const auto member=[&](const argument& entry) {
+            return (&entry==&object);
+        };
+        
+        if (std::find_if(begin(), end(), member)==end()) {
+            throw usage_error{"constraint outside of its range"};
+        }
+    }
+    
+    m_constraints.push_back({type, std::move(objects)});
+    m_index.reset();
+}
+
+auto range::constraints() const noexcept -> const std::vector<constraint>&
+{
+    return m_constraints;
+}
+
+schema& range::index() const
+{
+    if (!m_index && m_spare && m_spare->describes(*this)) {
+        m_index=std::move(m_spare);
+        m_index->refresh();
+    } else if (!m_index) {
+        m_index=std::make_shared<schema>(*this);
+    }
+    
+    m_spare.reset();
+    
+    return *m_index;
+}
+
+void range::recycle(const range& other) noexcept
+{
+    m_spare=other.m_index;
+}
+
+void tray::clear()
+{
+    throw usage_error{"tray without support for clear"};
+}
+
+void tray::extend(std::vector<std::string> values, pool*)
+{
+    for (std::size_t index{0}; index<values.size(); ++index) {
+        try {
+            append(std::move(values[index]));
+        } catch (const cast_error&) {
+            throw invalid_element{index, std::current_exception()};
+        }
+    }
+}
+
+std::any tray::snapshot() const
+{
+    return {};
+}
+
+void tray::restore(const std::any&)
+{
+}
+
+list<pooled>::operator bool() const noexcept
+{
+    return !empty();
+}
+
+bool list<pooled>::empty() const noexcept
+{
+    return m_values.empty();
+}
+
+std::size_t list<pooled>::size() const noexcept
+{
+    return m_values.size();
+}
+
+std::size_t list<pooled>::bytes() const noexcept
+{
+    return m_bytes;
+}
+
+auto list<pooled>::begin() const noexcept -> iterator
+{
+    return {*this, 0};
+}
+
+auto list<pooled>::end() const noexcept -> iterator
+{
+    return {*this, size()};
+}
+
+std::string_view list<pooled>::operator[](std::size_t index) const
+{
+    return m_values[index];
+}
+
+std::string_view list<pooled>::at(std::size_t index) const
+{
+    return m_values.at(index);
+}
+
+std::string_view list<pooled>::front() const
+{
+    return m_values.front();
+}
+
+std::string_view list<pooled>::back() const
+{
+    return m_values.back();
+}
+
+void list<pooled>::reserve(std::size_t count)
+{
+    m_values.reserve(count);
+}
+
+void list<pooled>::push(std::string_view value)
+{
+    if (value.empty()) { // nothing to store, and no block may exist yet
+        m_values.emplace_back();
+        return;
+    }
+    
+    char* target{nullptr};
+    
+    if (value.size()>block/4) { // a block of its own, behind the current one
+        auto storage=std::unique_ptr<char[]>{new char[value.size()]};
+        target=storage.get();
+        
+        m_blocks.insert(m_blocks.empty() ? m_blocks.end() :
+            std::prev(m_blocks.end()), std::move(storage));
+    } else {
+        if (block-m_used<value.size()) {
+            m_blocks.emplace_back(new char[block]); // left uninitialised
+            m_used=0;
+        }
+        
+        target=m_blocks.back().get()+m_used;
+        m_used+=value.size();
     }
+    
+    std::copy(value.begin(), value.end(), target);
+    
+    m_bytes+=value.size();
+    m_values.emplace_back(target, value.size());
+}
+
+void list<pooled>::append(std::string value)
+{
+    push(value);
+}
+
+void list<pooled>::clear()
+{
+    m_blocks.clear();
+    m_used=block;
+    
+    m_bytes=0;
+    m_values.clear();
+}
+
+list<interned>::operator bool() const noexcept
+{
+    return !empty();
+}
+
+bool list<interned>::empty() const noexcept
+{
+    return m_items.empty();
+}
+
+std::size_t list<interned>::size() const noexcept
+{
+    return m_items.size();
+}
+
+std::size_t list<interned>::distinct() const noexcept
+{
+    return m_strings.size();
+}
+
+auto list<interned>::begin() const noexcept -> iterator
+{
+    return {*this, 0};
+}
+
+auto list<interned>::end() const noexcept -> iterator
+{
+    return {*this, size()};
+}
+
+std::string_view list<interned>::operator[](std::size_t index) const
+{
+    return m_strings[m_items[index]];
+}
+
+std::string_view list<interned>::at(std::size_t index) const
+{
+    if (index>=size()) {
+        throw std::out_of_range{"interned list index out of range"};
+    }
+    
+    return operator[](index);
+}
+
+std::string_view list<interned>::front() const
+{
+    return operator[](0);
+}
+
+std::string_view list<interned>::back() const
+{
+    return operator[](size()-1);
+}
+
+void list<interned>::clear()
+{
+    m_strings.clear();
+    
+    m_items.clear();
+    std::fill(m_slots.begin(), m_slots.end(), 0);
+    m_hashes.clear();
+}
+
+void list<interned>::append(std::string value)
+{
+    const auto hash=std::hash<std::string_view>{}(value);
+    
+    if (m_strings.size()+1>m_slots.size()/2) { // grow at half load
+        m_slots.assign(std::max<std::size_t>(m_slots.size()*2, 16), 0);
+        
+        for (std::uint32_t string{0}; string<m_strings.size(); ++string) {
+            auto slot=m_hashes[string]&(m_slots.size()-1);
+            
+            while (m_slots[slot]!=0) {
+                slot=(slot+1)&(m_slots.size()-1);
+            }
+            
+            m_slots[slot]=string+1;
+        }
+    }
+    
+    auto slot=hash&(m_slots.size()-1);
+    
+    for (; m_slots[slot]!=0; slot=(slot+1)&(m_slots.size()-1)) {
+        if (const auto string=m_slots[slot]-1;
+            m_hashes[string]==hash && m_strings[string]==value) {
+            m_items.push_back(string);
+            return;
+        }
+    }
+    
+    m_slots[slot]=m_strings.size()+1;
+    m_items.push_back(m_strings.size());
+    m_hashes.push_back(hash);
+    
+    m_strings.push(value);
 }
 
 }
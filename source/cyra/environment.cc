@@ -0,0 +1,59 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cyra/environment.hh>
+
+#include <unistd.h>
+
+namespace cyra {
+
+environment::environment()
+    : environment{environ}
+{
+}
+
+environment::environment(const char* const* entries)
+{
+    // views stay valid as long as the entries do, which for the process
+    // environment means until it is modified
+    
+    for (; entries && *entries; ++entries) {
+        const std::string_view entry{*entries};
+        
+        if (const auto separator=entry.find('='); separator!=entry.npos) {
+            m_entries.emplace(entry.substr(0, separator),
+                entry.substr(separator+1)); // the first definition wins
+        }
+    }
+}
+
+auto environment::operator[](std::string_view name) const
+    -> std::optional<std::string_view>
+{
+    if (const auto entry=m_entries.find(name); entry!=m_entries.end()) {
+        return entry->second;
+    }
+    
+    return std::nullopt;
+}
+
+std::size_t environment::size() const noexcept
+{
+    return m_entries.size();
+}
+
+}
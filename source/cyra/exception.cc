@@ -17,6 +17,8 @@
 
 #include <cyra/exception.hh>
 
+#include <utility>
+
 namespace cyra {
 
 exception::exception(const std::string& what)
@@ -118,16 +120,89 @@ std::size_t invalid_decrement::decrement() const noexcept
     return m_decrement;
 }
 
+file_error::file_error(const std::string& path, const std::string& reason)
+    : runtime_error{"unable to use file "+path+": "+reason},
+        m_path{std::make_shared<std::string>(path)},
+        m_reason{std::make_shared<std::string>(reason)}
+{
+}
+
+const std::string& file_error::path() const noexcept
+{
+    return *m_path;
+}
+
+const std::string& file_error::reason() const noexcept
+{
+    return *m_reason;
+}
+
+namespace {
+
+std::string enumerate(const std::vector<std::string>& candidates)
+{
+    constexpr std::size_t limit{8};
+    
+    std::string result;
+    
+    for (std::size_t index{0}; index<candidates.size(); ++index) {
+        if (index==limit) {
+            return result+" and "+
+                std::to_string(candidates.size()-limit)+" more";
+        }
+        
+        result+=(index==0 ? "" : ", ")+candidates[index];
+    }
+    
+    return result;
+}
+
+std::string join(const std::vector<std::string>& items,
+    const std::string& conjunction)
+{
+    std::string result;
+    
+    for (std::size_t index{0}; index<items.size(); ++index) {
+        if (index>0) {
+            result+=(index+1==items.size()) ? ' '+conjunction+' ' : ", ";
+        }
+        
+        result+=items[index];
+    }
+    
+    return result;
+}
+
+std::string suggest(const std::vector<std::string>& suggestions)
+{
+    if (suggestions.empty()) {
+        return {};
+    }
+    
+    return ", did you mean "+join(suggestions, "or")+'?';
+}
+
+}
+
 invalid_argument::invalid_argument(const std::string& argument)
     : parsing_error{"unexpected argument "+argument},
-        m_description{std::make_shared<std::string>("argument "+argument)}
+        m_description{std::make_shared<std::string>("argument "+argument)},
+        m_suggestions{std::make_shared<std::vector<std::string>>()}
 {
 }
 
 invalid_argument::invalid_argument(const std::string& type,
     const std::string& key)
-    : parsing_error{"unexpected "+type+' '+key},
-        m_description{std::make_shared<std::string>(type+' '+key)}
+    : invalid_argument{type, key, {}}
+{
+}
+
+invalid_argument::invalid_argument(const std::string& type,
+    const std::string& key, std::vector<std::string> suggestions)
+    : parsing_error{"unexpected "+type+' '+key+suggest(suggestions)},
+        m_description{std::make_shared<std::string>(type+' '+key)},
+        m_suggestions{std::make_shared<std::vector<std::string>>(
+            std::move(suggestions))}
 {
 }
 
@@ -136,6 +211,32 @@ const std::string& invalid_argument::description() const noexcept
     return *m_description;
 }
 
+const std::vector<std::string>& invalid_argument::suggestions() const noexcept
+{
+    return *m_suggestions;
+}
+
+ambiguous_argument::ambiguous_argument(const std::string& type,
+    const std::string& key, std::vector<std::string> candidates)
+    : parsing_error{"ambiguous "+type+' '+key+
+        " could be "+enumerate(candidates)},
+        m_description{std::make_shared<std::string>(type+' '+key)},
+        m_candidates{std::make_shared<std::vector<std::string>>(
+            std::move(candidates))}
+{
+}
+
+const std::string& ambiguous_argument::description() const noexcept
+{
+    return *m_description;
+}
+
+const std::vector<std::string>&
+ambiguous_argument::candidates() const noexcept
+{
+    return *m_candidates;
+}
+
 deficient_count::deficient_count(const std::string& description,
     std::size_t count, std::size_t minimum)
     : count_error{description+
@@ -186,6 +287,43 @@ std::size_t excessive_count::maximum() const noexcept
     return m_maximum;
 }
 
+group_error::group_error(const std::string& what,
+    std::vector<std::string> descriptions)
+    : count_error{what},
+        m_descriptions{std::make_shared<std::vector<std::string>>(
+            std::move(descriptions))}
+{
+}
+
+const std::vector<std::string>& group_error::descriptions() const noexcept
+{
+    return *m_descriptions;
+}
+
+deficient_group::deficient_group(std::vector<std::string> descriptions)
+    : group_error{"one of "+join(descriptions, "or")+
+        " needs to be specified", descriptions}
+{
+}
+
+excessive_group::excessive_group(std::vector<std::string> descriptions)
+    : group_error{join(descriptions, "and")+
+        " may not be specified together", descriptions}
+{
+}
+
+unmet_implication::unmet_implication(const std::string& premise,
+    std::vector<std::string> descriptions)
+    : group_error{premise+" requires "+join(descriptions, "and"), descriptions},
+        m_premise{std::make_shared<std::string>(premise)}
+{
+}
+
+const std::string& unmet_implication::premise() const noexcept
+{
+    return *m_premise;
+}
+
 invalid_type::invalid_type(const std::string& value, const std::string& type)
     : cast_error{value+" is not "+type},
         m_value{std::make_shared<std::string>(value)},
@@ -193,6 +331,16 @@ invalid_type::invalid_type(const std::string& value, const std::string& type)
 {
 }
 
+invalid_type::invalid_type(const std::string& value, const std::string& type,
+    std::size_t position)
+    : cast_error{value+" is not "+type+
+        " (invalid at position "+std::to_string(position)+")"},
+        m_value{std::make_shared<std::string>(value)},
+        m_type{std::make_shared<std::string>(type)},
+        m_position{position}
+{
+}
+
 const std::string& invalid_type::value() const noexcept
 {
     return *m_value;
@@ -203,6 +351,66 @@ const std::string& invalid_type::type() const noexcept
     return *m_type;
 }
 
+std::size_t invalid_type::position() const noexcept
+{
+    return m_position;
+}
+
+namespace {
+
+std::string describe(const std::exception_ptr& cause)
+{
+    try {
+        std::rethrow_exception(cause);
+    } catch (const std::exception& error) {
+        return error.what();
+    } catch (...) {
+        return "unknown error";
+    }
+}
+
+}
+
+invalid_element::invalid_element(std::size_t index, std::exception_ptr cause)
+    : cast_error{"value "+std::to_string(index)+": "+describe(cause)},
+        m_argument{std::make_shared<std::string>()},
+        m_index{index},
+        m_cause{std::move(cause)}
+{
+}
+
+invalid_element::invalid_element(const std::string& argument,
+    std::size_t token, std::size_t index, std::exception_ptr cause)
+    : cast_error{"value "+std::to_string(index)+" of "+argument+
+        (token ? " (argument "+std::to_string(token)+")" : "")+": "+
+        describe(cause)},
+        m_argument{std::make_shared<std::string>(argument)},
+        m_token{token},
+        m_index{index},
+        m_cause{std::move(cause)}
+{
+}
+
+const std::string& invalid_element::argument() const noexcept
+{
+    return *m_argument;
+}
+
+std::size_t invalid_element::token() const noexcept
+{
+    return m_token;
+}
+
+std::size_t invalid_element::index() const noexcept
+{
+    return m_index;
+}
+
+std::exception_ptr invalid_element::cause() const noexcept
+{
+    return m_cause;
+}
+
 range_underflow::range_underflow(const std::string& value,
     const std::string& type)
     : range_error{value+" falling below range of "+type},
@@ -239,4 +447,88 @@ const std::string& range_overflow::type() const noexcept
     return *m_type;
 }
 
+limit_exceeded::limit_exceeded(const std::string& limit,
+    std::size_t maximum)
+    : parsing_error{"limit on "+limit+" of "+std::to_string(maximum)+
+        " exceeded"},
+        m_limit{std::make_shared<std::string>(limit)},
+        m_maximum{maximum}
+{
+}
+
+const std::string& limit_exceeded::limit() const noexcept
+{
+    return *m_limit;
+}
+
+std::size_t limit_exceeded::maximum() const noexcept
+{
+    return m_maximum;
+}
+
+unterminated_quote::unterminated_quote(char quote, std::size_t position)
+    : parsing_error{std::string{"unterminated "}+
+        ((quote=='\\') ? "escape" : "quote "+std::string(1, quote))+
+        " at position "+std::to_string(position)},
+        m_quote{quote},
+        m_position{position}
+{
+}
+
+char unterminated_quote::quote() const noexcept
+{
+    return m_quote;
+}
+
+std::size_t unterminated_quote::position() const noexcept
+{
+    return m_position;
+}
+
+duplicate_key::duplicate_key(const std::string& key)
+    : parsing_error{"key "+key+" is specified more than once"},
+        m_key{std::make_shared<std::string>(key)}
+{
+}
+
+const std::string& duplicate_key::key() const noexcept
+{
+    return *m_key;
+}
+
+missing_value::missing_value(const std::string& key)
+    : parsing_error{"key "+key+" requires a value"},
+        m_key{std::make_shared<std::string>(key)}
+{
+}
+
+const std::string& missing_value::key() const noexcept
+{
+    return *m_key;
+}
+
+configuration_error::configuration_error(const std::string& path,
+    std::size_t line, std::exception_ptr cause)
+    : parsing_error{path+":"+std::to_string(line)+": "+describe(cause)},
+        m_path{std::make_shared<std::string>(path)},
+        m_line{line},
+        m_cause{std::move(cause)}
+{
+}
+
+const std::string& configuration_error::path() const noexcept
+{
+    return *m_path;
+}
+
+std::size_t configuration_error::line() const noexcept
+{
+    return m_line;
+}
+
+std::exception_ptr configuration_error::cause() const noexcept
+{
+    return m_cause;
+}
+
 }
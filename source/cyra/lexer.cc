@@ -18,7 +18,7 @@
 #include <cyra/exception.hh>
 #include <cyra/lexer.hh>
 
-#include <regex>
+#include <algorithm>
 #include <utility>
 
 namespace cyra {
@@ -46,16 +46,87 @@ lexer& lexer::operator<<(std::string input)
     }
     
     m_input=std::move(input);
+    m_first=0;
+    
+    m_clustered=false;
+    m_ready=false;
+    
+    return *this;
+}
+
+lexer& lexer::operator<<(std::string_view input)
+{
+    if (!m_ready) {
+        throw usage_error{"lexer not ready"};
+    }
+    
+    m_input.assign(input.begin(), input.end());
+    m_first=0;
+    
+    m_clustered=false;
     m_ready=false;
     
     return *this;
 }
 
-bool posix::write(const std::string& input, command& output)
+lexer& lexer::operator<<(const option& input)
 {
-    static const std::regex expression{"[[:alnum:]\\-_]+"};
+    // the rest views the buffer, so that walking a cluster moves an offset
+    // instead of copying what remains of it
     
-    if (std::regex_match(input, expression)) {
+    if (!m_ready) {
+        throw usage_error{"lexer not ready"};
+    }
+    
+    const std::string_view buffer{m_input};
+    
+    if (!input.rest || input.rest->data()<buffer.data() ||
+        input.rest->data()+input.rest->size()!=buffer.data()+buffer.size()) {
+        throw usage_error{"rest not within the lexer input"};
+    }
+    
+    m_first=static_cast<std::size_t>(input.rest->data()-buffer.data());
+    
+    m_clustered=true;
+    m_ready=false;
+    
+    return *this;
+}
+
+bool lexer::clustered() const noexcept
+{
+    return m_clustered;
+}
+
+namespace {
+
+// linear scans in place of the former regular expressions, ASCII only
+
+constexpr bool alphanumeric(char character) noexcept
+{
+    return (character>='0' && character<='9') ||
+        (character>='a' && character<='z') ||
+        (character>='A' && character<='Z');
+}
+
+constexpr bool word(char character) noexcept
+{
+    return alphanumeric(character) || character=='-' || character=='_';
+}
+
+bool single(std::string_view input, std::size_t first) // like .* did
+{
+    return input.find_first_of("\n\r", first)==input.npos;
+}
+
+}
+
+bool posix::write(std::string_view input, command& output)
+{
+    // [[:alnum:]-_]+, never the rest of a cluster
+    
+    if (!clustered() && !input.empty() &&
+        std::all_of(input.begin(), input.end(), word)) {
         output.key=input;
         return true;
     }
@@ -63,60 +134,82 @@ bool posix::write(const std::string& input, command& output)
     return false;
 }
 
-bool posix::write(const std::string& input, option& output)
+bool posix::write(std::string_view input, option& output)
 {
-    if (input=="--") {
+    if (clustered()) { // checked as the value of the preceding option
+        if (input.empty() || !alphanumeric(input[0])) {
+            return false;
+        }
+        
+        output.key={'-', input[0]};
+        input.remove_prefix(1);
+    } else if (input=="--") {
         output.key=input;
         return true;
+    } else if (input.size()>=2 && input[0]=='-' && alphanumeric(input[1]) &&
+        single(input, 2)) {
+        // -[[:alnum:]] followed by a value, or by further clustered options
+        
+        output.key=input.substr(0, 2);
+        input.remove_prefix(2);
+    } else {
+        return false;
     }
     
-    static const std::regex primary{"(\\-[[:alnum:]])(.*)"};
-    
-    if (std::smatch result; std::regex_match(input, result, primary)) {
-        output.key=result[1];
-        
-        if (!result[2].str().empty()) {
-            output.value=result[2];
-        }
-        
-        static const std::regex secondary{"[[:alnum:]].*"};
+    if (!input.empty()) {
+        output.value=input;
         
-        if (output.value&&std::regex_match(output.value.value(), secondary)) {
-            output.rest = '-'+output.value.value();
+        if (alphanumeric(input[0])) {
+            output.rest=input;
         }
-        
-        return true;
     }
     
-    return false;
+    return true;
 }
 
-bool posix::write(const std::string& input, operand& output)
+bool posix::write(std::string_view input, operand& output)
 {
-    output.value=input;
+    output.value=clustered() ? '-'+std::string{input} : std::string{input};
     return true;
 }
 
-bool gnu::write(const std::string& input, option& output)
+bool gnu::write(std::string_view input, option& output)
 {
     if (posix::write(input, output)) {
         return true;
     }
     
-    static const std::regex expression{
-        "(\\-\\-[[:alnum:]][[:alnum:]\\-]+)(\\=(.*))?"};
+    // --[[:alnum:]][[:alnum:]-]+ optionally followed by =value
     
-    if (std::smatch result; std::regex_match(input, result, expression)) {
-        output.key=result[1];
-        
-        if (!result[2].str().empty()) {
-            output.value=result[3];
+    if (clustered() || input.size()<4 || input.substr(0, 2)!="--" ||
+        !alphanumeric(input[2])) {
+        return false;
+    }
+    
+    const auto separator=input.find('=', 3);
+    const auto end=(separator==input.npos) ? input.size() : separator;
+    
+    for (auto index=std::size_t{3}; index<end; ++index) {
+        if (!alphanumeric(input[index]) && input[index]!='-') {
+            return false;
         }
-        
-        return true;
     }
     
-    return false;
+    if (end==3) {
+        return false;
+    }
+    
+    if (separator!=input.npos && !single(input, separator+1)) {
+        return false;
+    }
+    
+    output.key=input.substr(0, end);
+    
+    if (separator!=input.npos) {
+        output.value=input.substr(separator+1);
+    }
+    
+    return true;
 }
 
 }
@@ -16,13 +16,29 @@
 */
 
 #include <cyra/argument.hh>
+#include <cyra/batch.hh>
+#include <cyra/cache.hh>
+#include <cyra/cast.hh>
 #include <cyra/container.hh>
 #include <cyra/commandline.hh>
+#include <cyra/configuration.hh>
+#include <cyra/environment.hh>
 #include <cyra/exception.hh>
 #include <cyra/lexer.hh>
 #include <cyra/parser.hh>
+#include <cyra/schema.hh>
+#include <cyra/statistics.hh>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <functional>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <typeinfo>
 #include <utility>
 
 namespace cyra {
@@ -34,10 +50,39 @@ parser::parser(lexer& style)
 
 namespace {
 
+class stopwatch {
+public:
+    explicit stopwatch(std::chrono::nanoseconds* target)
+        : m_target{target}
+    {
+        if (m_target) {
+            m_start=std::chrono::steady_clock::now();
+        }
+    }
+    
+    ~stopwatch()
+    {
+        if (m_target) {
+            *m_target+=std::chrono::steady_clock::now()-m_start;
+        }
+    }
+    
+private:
+    std::chrono::nanoseconds* m_target;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+void note(trace* target, trace::event type, std::size_t token) noexcept
+{
+    if (target) {
+        target->push(type, token);
+    }
+}
+
 void verify(const range& scope)
 {
     for (const argument& object:scope) {
-        if (object.count().lower()) {
+        if (object.count().lower() && !object.defaulted()) {
             throw deficient_count{object.name(),
                 object.count(), object.count().minimum()};
         } else if (object.count().upper()) {
@@ -55,18 +100,87 @@ void verify(const range& scope)
             verify(*next);
         }
     }
+    
+    scope.index().enforce();
 }
 
 }
 
 commandline& parser::operator()(commandline& terminal)
 {
+    // a parse that threw leaves its state behind, including input the
+    // lexer has not taken yet
+    
+    m_style << true;
+    
     m_scope=&terminal;
+    m_last=nullptr;
     
-    while (!terminal.m_arguments.empty() || !m_style) {
+    m_operand=false;
+    m_value=false;
+    
+    m_token=0;
+    
+    m_cluster=0;
+    m_depth=0;
+    m_bytes=0;
+    
+    m_pending.clear();
+    m_slots.clear();
+    m_routed=0;
+    
+    try {
+        check(terminal); // reject oversized input before any lexing
+        
+        if (m_cache && !m_configuration) {
+            auto index=key(terminal);
+            
+            if (m_cache->restore(index, terminal)) {
+                terminal.m_next=terminal.m_arguments.size();
+            } else {
+                reset(terminal); // start from scratch, as a hit does
+                process(terminal);
+                m_cache->store(std::move(index), terminal);
+            }
+        } else {
+            process(terminal);
+        }
+    } catch (...) {
+        if (m_statistics) {
+            ++m_statistics->exceptions;
+        }
+        
+        note(m_trace, trace::event::error, m_token);
+        throw;
+    }
+    
+    if (m_statistics) {
+        m_statistics->footprint=terminal.index().measure();
+    }
+    
+    m_scope=nullptr;
+    m_last=nullptr;
+    
+    m_operand=false;
+    m_value=false;
+    
+    terminal.m_good=true;
+    
+    return terminal;
+}
+
+void parser::process(commandline& terminal)
+{
+    while (terminal.m_next<terminal.m_arguments.size() || !m_style) {
         if (m_style) {
-            m_style << terminal.m_arguments.front();
-            terminal.m_arguments.pop();
+            m_style << terminal.m_arguments[terminal.m_next++];
+            m_cluster=0;
+            
+            note(m_trace, trace::event::token, ++m_token);
+            
+            if (m_statistics) {
+                ++m_statistics->tokens;
+            }
         }
         
         if (m_value&&option()) {
@@ -75,32 +189,88 @@ commandline& parser::operator()(commandline& terminal)
         
         if (!command() && !option() && !operand()) {
             lexer::operand argument;
-            m_style >> argument;
+            lex(argument);
             
             throw invalid_argument{argument.value};
         }
     }
     
-    verify(terminal);
+    const auto routed=std::exchange(m_token, 0); // the rest has no token
     
-    m_scope=nullptr;
-    m_last=nullptr;
+    std::optional<environment> local; // taken once, only when needed
+    bind(terminal, local);
     
-    m_operand=false;
-    m_value=false;
+    if (m_configuration) { // after the environment, which takes precedence
+        load(terminal, *m_configuration);
+    }
     
-    terminal.m_good=true;
+    m_token=routed;
+    flush();
     
-    return terminal;
+    stopwatch timer{m_statistics ? &m_statistics->verify : nullptr};
+    note(m_trace, trace::event::verify, m_token);
+    
+    verify(terminal);
+}
+
+void parser::abbreviate(bool enable) noexcept
+{
+    m_abbreviate=enable;
+}
+
+void parser::measure(statistics* target) noexcept
+{
+    m_statistics=target;
+}
+
+void parser::record(trace* target) noexcept
+{
+    m_trace=target;
+}
+
+void parser::snapshot(const environment* source) noexcept
+{
+    m_environment=source;
+}
+
+void parser::configure(const configuration* source) noexcept
+{
+    m_configuration=source;
+}
+
+void parser::restrict(const limits& bounds) noexcept
+{
+    m_limits=bounds;
+}
+
+void parser::pipeline(pool* workers) noexcept
+{
+    m_pool=workers;
+}
+
+void parser::memoize(cache* results) noexcept
+{
+    m_cache=results;
 }
 
 namespace {
 
 template<typename Function>
-bool query(argument::category type,
-    const std::string& key, const range& scope, const Function& call)
+bool query(argument::category type, const std::string& key,
+    const range& scope, statistics* target, const Function& call)
 {
-    if (auto result=scope.query(key); result) {
+    std::optional<std::reference_wrapper<argument>> result;
+    
+    if (target) {
+        stopwatch timer{&target->match};
+        
+        ++target->lookups;
+        result=scope.query(key);
+    } else {
+        result=scope.query(key);
+    }
+    
+    if (result) {
         argument& object=result.value();
         
         if (object.type()==type) {
@@ -115,18 +285,28 @@ bool query(argument::category type,
 
 bool parser::command()
 {
-    if (lexer::command command; m_style >> command) {
+    if (lexer::command command; lex(command)) {
         return query(argument::category::command,
-            command.key, *m_scope, [&](auto& object) {
+            command.key, *m_scope, m_statistics, [&](auto& object) {
             object.name().match(command.key);
             ++object.count();
             
+            if (++m_depth>m_limits.depth) {
+                throw limit_exceeded{"depth", m_limits.depth};
+            }
+            
             m_scope=dynamic_cast<range*>(&object);
             
             if (!m_scope) {
                 throw type_error{"command", "range"};
             }
             
+            if (const auto scope=dynamic_cast<cyra::command*>(&object); scope) {
+                scope->populate();
+            }
+            
+            note(m_trace, trace::event::command, m_token);
+            
             m_last=&object;
             return true;
         });
@@ -137,7 +317,7 @@ bool parser::command()
 
 bool parser::option()
 {
-    if (lexer::option option; !m_operand && (m_style >> option)) {
+    if (lexer::option option; !m_operand && lex(option)) {
         if (option.key=="--") {
             m_operand=true;
             return true;
@@ -148,13 +328,23 @@ bool parser::option()
                 m_last->count(), m_last->count().minimum()};
         }
         
+        if (m_abbreviate && !m_scope->query(option.key)) {
+            const auto& index=m_scope->index();
+            
+            if (const auto position=index.abbreviate(option.key); position) {
+                option.key=index.key(position.value());
+            }
+        }
+        
         const auto success=query(argument::category::option,
-            option.key, *m_scope, [&](auto& object) {
+            option.key, *m_scope, m_statistics, [&](auto& object) {
             object.name().match(option.key);
+            note(m_trace, trace::event::option, m_token);
             
             if (const auto storage=dynamic_cast<tray*>(&object); storage) {
                 if (option.value) {
-                    storage->append(std::move(option.value.value()));
+                    note(m_trace, trace::event::value, m_token);
+                    store(*storage, std::string{option.value.value()});
                     ++object.count();
                 } else if (object.count().lower()) {
                     m_value=true;
@@ -163,7 +353,11 @@ bool parser::option()
                 ++object.count();
                 
                 if (option.rest) {
-                    m_style << std::move(option.rest.value());
+                    if (++m_cluster>=m_limits.cluster) {
+                        throw limit_exceeded{"cluster", m_limits.cluster};
+                    }
+                    
+                    m_style << option; // the rest, walked in place
                 }
             }
             
@@ -172,16 +366,18 @@ bool parser::option()
         });
         
         if (!success && !m_operand) {
-            throw invalid_argument{"option", option.key};
+            throw invalid_argument{"option", option.key,
+                m_scope->index().suggest(option.key)};
         }
         
         return success;
     } else if (m_value) {
         lexer::operand operand;
-        m_style >> operand;
+        lex(operand);
         
         if (const auto storage=dynamic_cast<tray*>(m_last); storage) {
-            storage->append(std::move(operand.value));
+            note(m_trace, trace::event::value, m_token);
+            store(*storage, std::move(operand.value));
         } else {
             throw type_error{"argument", "tray"};
         }
@@ -197,7 +393,7 @@ bool parser::option()
 
 bool parser::operand()
 {
-    if (lexer::operand operand; m_style >> operand) {
+    if (lexer::operand operand; lex(operand)) {
         for (argument& object:*m_scope) {
             if (object.type()==argument::category::operand &&
                 object.count().value()<object.count().maximum()) {
@@ -207,7 +403,9 @@ bool parser::operand()
                     throw type_error{"argument", "tray"};
                 }
                 
-                storage->append(std::move(operand.value));
+                note(m_trace, trace::event::operand, m_token);
+                
+                store(*storage, std::move(operand.value));
                 ++object.count();
                 
                 return true;
@@ -218,4 +416,290 @@ bool parser::operand()
     return false;
 }
 
+template<typename Type>
+bool parser::lex(Type& output)
+{
+    if (m_statistics) {
+        stopwatch timer{&m_statistics->lex};
+        
+        ++m_statistics->attempts;
+        return static_cast<bool>(m_style >> output);
+    }
+    
+    return static_cast<bool>(m_style >> output);
+}
+
+void parser::check(const commandline& terminal) const
+{
+    const auto first=terminal.m_arguments.begin()+terminal.m_next;
+    const auto last=terminal.m_arguments.end();
+    
+    if (static_cast<std::size_t>(last-first)>m_limits.tokens) {
+        throw limit_exceeded{"tokens", m_limits.tokens};
+    }
+    
+    if (m_limits.length!=limits::unbounded) {
+        for (auto current=first; current!=last; ++current) {
+            if (current->size()>m_limits.length) {
+                throw limit_exceeded{"length", m_limits.length};
+            }
+        }
+    }
+}
+
+std::string parser::key(const commandline& terminal) const
+{
+    // the schema fingerprint of the root, the settings affecting the
+    // outcome, then the arguments, each prefixed with its size; nested
+    // commands are checked by the cache, for those a result enters
+    
+    std::string result;
+    
+    const auto append=[&](std::size_t number) {
+        result.append(reinterpret_cast<const char*>(&number), sizeof number);
+    };
+    
+    append(terminal.index().fingerprint());
+    append(typeid(m_style).hash_code());
+    append(m_abbreviate);
+    
+    for (const auto bound:{m_limits.tokens, m_limits.length,
+        m_limits.cluster, m_limits.depth, m_limits.bytes}) {
+        append(bound);
+    }
+    
+    for (auto index=terminal.m_next; index<terminal.m_arguments.size();
+        ++index) {
+        append(terminal.m_arguments[index].size());
+        result.append(terminal.m_arguments[index]);
+    }
+    
+    return result;
+}
+
+void parser::store(tray& storage, std::string value)
+{
+    if ((m_bytes+=value.size())>m_limits.bytes) {
+        throw limit_exceeded{"bytes", m_limits.bytes};
+    }
+    
+    if (m_statistics) {
+        static const auto local=std::string{}.capacity();
+        
+        ++m_statistics->stores;
+        m_statistics->heap_values+=(value.size()>local);
+    }
+    
+    if (m_pool) { // routed now, cast by flush
+        const auto [slot, added]=m_slots.try_emplace(&storage,
+            m_pending.size());
+        
+        if (added) {
+            m_pending.push_back({&storage, {}, {}, {}});
+        }
+        
+        auto& entry=m_pending[slot->second];
+        
+        entry.values.push_back(std::move(value));
+        entry.tokens.push_back(m_token);
+        entry.orders.push_back(m_routed++);
+        
+        return;
+    }
+    
+    stopwatch timer{m_statistics ? &m_statistics->store : nullptr};
+    
+    try {
+        storage.append(std::move(value));
+    } catch (const cast_error&) { // as flush reports it
+        const auto object=dynamic_cast<argument*>(&storage);
+        
+        if (!object) {
+            throw;
+        }
+        
+        throw invalid_element{object->name(), m_token,
+            object->count().value(), std::current_exception()};
+    }
+}
+
+void parser::bind(range& scope, std::optional<environment>& local)
+{
+    for (argument& object:scope) {
+        auto entry=dynamic_cast<cyra::option*>(&object);
+        
+        if (entry && !object && entry->variable()) {
+            if (!m_environment && !local) {
+                local.emplace();
+            }
+            
+            const auto& source=m_environment ? *m_environment : *local;
+            
+            if (const auto text=source[*entry->variable()]; text) {
+                if (assign(object, std::string{*text})) {
+                    object.provenance(argument::origin::environment);
+                }
+            }
+        }
+        
+        if (object && object.type()==argument::category::command) {
+            if (auto next=dynamic_cast<range*>(&object); next) {
+                bind(*next, local);
+            }
+        }
+    }
+}
+
+namespace {
+
+range* locate(range& root, std::string_view path)
+{
+    // dotted path of commands, null when one of them was not given
+    
+    range* scope{&root};
+    
+    while (!path.empty()) {
+        const auto name=std::string{path.substr(0, path.find('.'))};
+        path.remove_prefix(std::min(path.size(), name.size()+1));
+        
+        const auto result=scope->query(name);
+        const auto type=result ? result.value().get().type() :
+            argument::category::operand;
+        
+        if (type!=argument::category::command) {
+            throw invalid_argument{"command", name,
+                scope->index().suggest(name)};
+        }
+        
+        argument& object=result.value();
+        
+        if (!object) {
+            return nullptr;
+        }
+        
+        scope=dynamic_cast<range*>(&object);
+        
+        if (!scope) {
+            throw type_error{"command", "range"};
+        }
+    }
+    
+    return scope;
+}
+
+}
+
+void parser::load(range& root, const configuration& source)
+{
+    std::string key{"--"}; // reused for every lookup
+    
+    std::optional<std::string_view> section;
+    range* scope{nullptr};
+    
+    for (const auto& entry:source) {
+        try {
+            if (!section || section.value()!=entry.section) {
+                section=entry.section;
+                scope=locate(root, entry.section);
+            }
+            
+            if (!scope) {
+                continue;
+            }
+            
+            key.resize(2);
+            key.append(entry.key);
+            
+            setting(*scope, key, entry.value);
+        } catch (const parsing_error&) {
+            throw configuration_error{source.name(), entry.line,
+                std::current_exception()};
+        }
+    }
+}
+
+void parser::setting(range& scope, const std::string& key,
+    std::optional<std::string_view> value)
+{
+    const auto result=query(argument::category::option,
+        key, scope, m_statistics, [&](argument& object) {
+        if (object && object.provenance()!=argument::origin::configuration) {
+            return true; // given on the command line or the environment
+        }
+        
+        object.name().match(key);
+        
+        if (value) {
+            if (assign(object, std::string{value.value()})) {
+                object.provenance(argument::origin::configuration);
+            }
+        } else if (!dynamic_cast<tray*>(&object)) {
+            ++object.count();
+            object.provenance(argument::origin::configuration);
+        } else {
+            throw missing_value{key};
+        }
+        
+        return true;
+    });
+    
+    if (!result) {
+        throw invalid_argument{"option", key, scope.index().suggest(key)};
+    }
+}
+
+bool parser::assign(argument& object, std::string value)
+{
+    // values take the same cast path as on the command line, flags are
+    // only raised by a true boolean
+    
+    if (auto storage=dynamic_cast<tray*>(&object); storage) {
+        store(*storage, std::move(value));
+    } else if (!cast<bool>(std::string_view{value})) {
+        return false;
+    }
+    
+    ++object.count();
+    return true;
+}
+
+void parser::flush()
+{
+    stopwatch timer{m_statistics ? &m_statistics->store : nullptr};
+    
+    // every tray is extended, so that the value reported is the first one
+    // routed, as when each value is cast as it is stored
+    
+    std::exception_ptr failure;
+    auto first=std::numeric_limits<std::size_t>::max(); // routing order
+    
+    for (auto& entry:m_pending) {
+        try {
+            entry.storage->extend(std::move(entry.values), m_pool);
+        } catch (const invalid_element& error) {
+            const auto object=dynamic_cast<argument*>(entry.storage);
+            const auto index=error.index();
+            
+            if (!object || index>=entry.tokens.size()) {
+                throw;
+            }
+            
+            if (entry.orders[index]<first) {
+                first=entry.orders[index];
+                m_token=entry.tokens[index]; // for the trace
+                
+                failure=std::make_exception_ptr(invalid_element{
+                    object->name(), m_token, index, error.cause()});
+            }
+        }
+    }
+    
+    m_pending.clear();
+    m_slots.clear();
+    
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
 }
@@ -0,0 +1,191 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cyra/exception.hh>
+#include <cyra/pool.hh>
+
+#include <algorithm>
+
+namespace cyra {
+
+namespace {
+
+thread_local const pool* current{nullptr}; // served by this thread
+
+}
+
+pool::pool(std::size_t threads)
+    : m_queues{std::make_unique<queue[]>(std::max<std::size_t>(threads, 1))}
+{
+    threads=std::max<std::size_t>(threads, 1);
+    m_threads.reserve(threads);
+    
+    for (std::size_t worker{0}; worker<threads; ++worker) {
+        m_threads.emplace_back([this, worker] {
+            serve(worker);
+        });
+    }
+}
+
+pool::~pool()
+{
+    {
+        std::lock_guard<std::mutex> guard{m_lock};
+        m_stop=true;
+    }
+    
+    m_start.notify_all();
+    
+    for (auto& thread:m_threads) {
+        thread.join();
+    }
+}
+
+std::size_t pool::size() const noexcept
+{
+    return m_threads.size();
+}
+
+void pool::run(std::size_t count, const task& work)
+{
+    if (inside()) {
+        throw usage_error{"pool run from one of its own workers"};
+    }
+    
+    if (count==0) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> exclusive{m_run};
+    
+    // several chunks per worker, so that an uneven share can be stolen
+    
+    const auto workers=size();
+    const auto grain=std::max<std::size_t>(count/(workers*8), 1);
+    
+    for (std::size_t first{0}, worker{0}; first<count; first+=grain) {
+        auto& target=m_queues[worker];
+        worker=(worker+1)%workers;
+        
+        std::lock_guard<std::mutex> guard{target.lock};
+        target.chunks.emplace_back(first, std::min(first+grain, count));
+    }
+    
+    std::unique_lock<std::mutex> guard{m_lock};
+    
+    m_work=&work;
+    m_busy=workers;
+    m_error=nullptr;
+    ++m_generation;
+    
+    m_start.notify_all();
+    m_finish.wait(guard, [this] {
+        return m_busy==0;
+    });
+    
+    m_work=nullptr;
+    
+    if (const auto error=std::exchange(m_error, nullptr); error) {
+        std::rethrow_exception(error);
+    }
+}
+
+bool pool::inside() const noexcept
+{
+    return current==this;
+}
+
+void pool::serve(std::size_t worker)
+{
+    std::size_t generation{0};
+    current=this;
+    
+    while (true) {
+        const task* work{nullptr};
+        
+        {
+            std::unique_lock<std::mutex> guard{m_lock};
+            
+            m_start.wait(guard, [&] {
+                return m_stop || m_generation!=generation;
+            });
+            
+            if (m_stop) {
+                return;
+            }
+            
+            generation=m_generation;
+            work=m_work;
+        }
+        
+        drain(worker, *work);
+        
+        std::lock_guard<std::mutex> guard{m_lock};
+        
+        if (--m_busy==0) {
+            m_finish.notify_one();
+        }
+    }
+}
+
+void pool::drain(std::size_t worker, const task& work)
+{
+    for (chunk current; take(worker, current); ) {
+        for (auto index=current.first; index<current.second; ++index) {
+            try {
+                work(index, worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard{m_lock};
+                
+                if (!m_error) {
+                    m_error=std::current_exception();
+                }
+            }
+        }
+    }
+}
+
+bool pool::take(std::size_t worker, chunk& output)
+{
+    {
+        auto& own=m_queues[worker];
+        std::lock_guard<std::mutex> guard{own.lock};
+        
+        if (!own.chunks.empty()) {
+            output=own.chunks.front();
+            own.chunks.pop_front();
+            
+            return true;
+        }
+    }
+    
+    for (std::size_t offset{1}; offset<size(); ++offset) {
+        auto& victim=m_queues[(worker+offset)%size()];
+        std::lock_guard<std::mutex> guard{victim.lock};
+        
+        if (!victim.chunks.empty()) {
+            output=victim.chunks.back();
+            victim.chunks.pop_back();
+            
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+}
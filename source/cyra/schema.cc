@@ -0,0 +1,694 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cyra/container.hh>
+#include <cyra/exception.hh>
+#include <cyra/schema.hh>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+namespace cyra {
+
+namespace {
+
+constexpr auto saturation=std::numeric_limits<std::uint32_t>::max();
+
+std::uint32_t pack(std::size_t value) noexcept
+{
+    return static_cast<std::uint32_t>(std::min<std::size_t>(value, saturation));
+}
+
+std::size_t unpack(std::uint32_t value) noexcept
+{
+    if (value==saturation) {
+        return std::numeric_limits<std::size_t>::max();
+    }
+    
+    return value;
+}
+
+std::size_t population(std::uint64_t bits) noexcept
+{
+    bits-=(bits>>1)&0x5555555555555555;
+    bits=(bits&0x3333333333333333)+((bits>>2)&0x3333333333333333);
+    bits=(bits+(bits>>4))&0x0f0f0f0f0f0f0f0f;
+    
+    return static_cast<std::size_t>((bits*0x0101010101010101)>>56);
+}
+
+std::size_t heap(const std::string& value) noexcept
+{
+    static const auto local=std::string{}.capacity();
+    return (value.capacity()>local) ? value.capacity()+1 : 0;
+}
+
+std::size_t heap(const std::optional<std::string>& value) noexcept
+{
+    return value ? heap(value.value()) : 0;
+}
+
+template<typename Type>
+std::size_t heap(const std::vector<Type>& values) noexcept
+{
+    return values.capacity()*sizeof(Type);
+}
+
+// bit-parallel edit distance against a fixed pattern (Myers, Hyyrö)
+class metric {
+public:
+    static constexpr std::size_t capacity{64};
+    
+    struct state {
+        std::uint64_t positive; // vertical deltas of the current column
+        std::uint64_t negative;
+        
+        std::size_t score; // distance of the whole pattern
+    };
+    
+    explicit metric(std::string_view pattern) // at most capacity characters
+        : m_size{pattern.size()}
+    {
+        for (std::size_t index{0}; index<m_size; ++index) {
+            m_masks[static_cast<unsigned char>(pattern[index])]|=
+                std::uint64_t{1}<<index;
+        }
+    }
+    
+    state start() const noexcept
+    {
+        return {~std::uint64_t{0}, 0, m_size};
+    }
+    
+    state step(state current, unsigned char character) const noexcept
+    {
+        const auto equal=m_masks[character];
+        const auto& [positive, negative, score]=current;
+        
+        const auto vertical=equal|negative;
+        const auto horizontal=(((equal&positive)+positive)^positive)|equal;
+        
+        auto up=negative|~(horizontal|positive);
+        auto down=positive&horizontal;
+        
+        auto result=score;
+        
+        if ((up>>(m_size-1))&1) {
+            ++result;
+        } else if ((down>>(m_size-1))&1) {
+            --result;
+        }
+        
+        up=(up<<1)|1;
+        down<<=1;
+        
+        return {down|~(vertical|up), up&vertical, result};
+    }
+    
+    // lower bound on the distance of any text continuing the current one
+    std::size_t bound(const state& current, std::size_t depth,
+        std::size_t band) const noexcept
+    {
+        const auto first=depth-std::min(depth, band);
+        const auto last=std::min(depth+band, m_size);
+        
+        if (first>last) {
+            return std::numeric_limits<std::size_t>::max();
+        }
+        
+        const auto mask=(first==capacity) ? ~std::uint64_t{0} :
+            (std::uint64_t{1}<<first)-1;
+        
+        // cell values down the column, starting at the top of the band
+        auto value=depth+population(current.positive&mask)-
+            population(current.negative&mask);
+        auto result=value;
+        
+        for (auto row=first; row<last; ++row) {
+            value+=(current.positive>>row)&1;
+            value-=(current.negative>>row)&1;
+            
+            result=std::min(result, value);
+        }
+        
+        return result;
+    }
+    
+private:
+    std::size_t m_size;
+    std::array<std::uint64_t, 256> m_masks{};
+    
+};
+
+std::size_t tolerance(std::size_t length) noexcept
+{
+    return (length<=4) ? 1 : (length<=8) ? 2 : 3;
+}
+
+std::uint64_t digest(std::uint64_t hash, const void* data,
+    std::size_t size) noexcept // FNV-1a
+{
+    const auto bytes=static_cast<const unsigned char*>(data);
+    
+    for (std::size_t index{0}; index<size; ++index) {
+        hash=(hash^bytes[index])*0x100000001B3;
+    }
+    
+    return hash;
+}
+
+template<typename Type> // elements, then their number as a separator
+std::uint64_t digest(std::uint64_t hash, const std::vector<Type>& data)
+{
+    const auto size=data.size();
+    hash=digest(hash, data.data(), size*sizeof(Type));
+    
+    return digest(hash, &size, sizeof size);
+}
+
+}
+
+schema::schema(const range& scope)
+{
+    std::vector<std::pair<std::string_view, std::uint32_t>> keys;
+    
+    for (argument& object:scope) {
+        const auto index=pack(m_objects.size());
+        
+        for (const auto& key:object.name().keys()) {
+            keys.emplace_back(key, index);
+        }
+        
+        m_objects.push_back(&object);
+        m_types.push_back(static_cast<std::uint8_t>(object.type()));
+        m_minimum.push_back(pack(object.count().minimum()));
+        m_maximum.push_back(pack(object.count().maximum()));
+        m_counts.push_back(pack(object.count().value()));
+    }
+    
+    // the first argument in the range owns a key, as with a linear search
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end(), [](auto& a, auto& b) {
+        return (a.first==b.first);
+    }), keys.end());
+    
+    m_offsets.reserve(keys.size()+1);
+    m_owners.reserve(keys.size());
+    
+    for (const auto& [key, owner]:keys) {
+        m_offsets.push_back(pack(m_pool.size()));
+        m_owners.push_back(owner);
+        
+        m_pool.append(key);
+    }
+    
+    m_offsets.push_back(pack(m_pool.size()));
+    
+    if (const auto [first, last]=prefix("--"); first<last) {
+        grow(first, last, 2);
+    }
+    
+    compile(scope);
+    
+    std::vector<std::uint32_t> rules; // without padding
+    
+    for (const auto& item:m_rules) {
+        rules.insert(rules.end(), {static_cast<std::uint32_t>(item.type),
+            item.premise, item.first, item.last});
+    }
+    
+    auto hash=digest(0xCBF29CE484222325, m_pool.data(), m_pool.size());
+    
+    hash=digest(hash, m_offsets);
+    hash=digest(hash, m_owners);
+    hash=digest(hash, m_types);
+    hash=digest(hash, m_minimum);
+    hash=digest(hash, m_maximum);
+    hash=digest(hash, rules);
+    
+    m_fingerprint=digest(hash, m_masks);
+}
+
+std::size_t schema::size() const noexcept
+{
+    return m_objects.size();
+}
+
+std::optional<std::size_t> schema::find(std::string_view key) const
+{
+    const auto first=lower(key);
+    
+    if (first<m_owners.size() && this->key(first)==key) {
+        return m_owners[first];
+    }
+    
+    return {};
+}
+
+std::optional<std::size_t> schema::abbreviate(std::string_view prefix) const
+{
+    if (m_nodes.empty() || prefix.size()<=2 || prefix.substr(0, 2)!="--") {
+        return {};
+    }
+    
+    std::uint32_t current{0};
+    
+    for (auto character:prefix.substr(2)) {
+        const auto first=m_labels.begin()+m_nodes[current].first;
+        const auto last=m_labels.begin()+m_nodes[current].last;
+        
+        const auto edge=std::lower_bound(first, last, character);
+        
+        if (edge==last || *edge!=character) {
+            return {};
+        }
+        
+        current=m_children[edge-m_labels.begin()];
+    }
+    
+    if (m_nodes[current].owner==saturation) {
+        const auto [first, last]=this->prefix(prefix);
+        
+        std::vector<std::string> candidates;
+        
+        for (auto position=first; position<last; ++position) {
+            candidates.emplace_back(key(position));
+        }
+        
+        throw ambiguous_argument{"option", std::string{prefix},
+            std::move(candidates)};
+    }
+    
+    return m_nodes[current].position;
+}
+
+std::vector<std::string> schema::suggest(std::string_view key,
+    std::size_t limit) const
+{
+    if (key.empty() || key.size()>metric::capacity) {
+        return {};
+    }
+    
+    const metric distance{key};
+    const auto maximum=tolerance(key.size());
+    
+    const auto dashed=(key.substr(0, 1)=="-");
+    auto [position, last]=dashed ? prefix("-") : prefix("");
+    
+    std::vector<std::pair<std::size_t, std::size_t>> ranking;
+    
+    // walks the sorted keys as an implicit trie, sharing the columns of
+    // common prefixes and skipping prefixes that are already too distant
+    std::vector<metric::state> columns{distance.start()};
+    std::string_view previous;
+    
+    while (position<last) {
+        const auto item=this->key(position);
+        
+        const auto common=std::mismatch(item.begin(), item.end(),
+            previous.begin(), previous.end()).first-item.begin();
+        
+        columns.resize(std::min<std::size_t>(common, columns.size()-1)+1);
+        previous=item;
+        
+        auto next=position+1;
+        
+        for (auto depth=columns.size()-1; depth<item.size(); ++depth) {
+            columns.push_back(distance.step(columns.back(), item[depth]));
+            
+            if (distance.bound(columns.back(), depth+1, maximum)>maximum) {
+                next=skip(position, depth+1);
+                break;
+            }
+        }
+        
+        if (columns.size()==item.size()+1 && columns.back().score<=maximum &&
+            (item.substr(0, 1)=="-")==dashed) {
+            ranking.emplace_back(columns.back().score, position);
+        }
+        
+        position=next;
+    }
+    
+    std::sort(ranking.begin(), ranking.end());
+    ranking.resize(std::min(ranking.size(), limit));
+    
+    std::vector<std::string> result;
+    
+    for (const auto& entry:ranking) {
+        result.emplace_back(this->key(entry.second));
+    }
+    
+    return result;
+}
+
+std::size_t schema::keys() const noexcept
+{
+    return m_owners.size();
+}
+
+std::string_view schema::key(std::size_t position) const noexcept
+{
+    return std::string_view{m_pool}.substr(m_offsets[position],
+        m_offsets[position+1]-m_offsets[position]);
+}
+
+std::size_t schema::owner(std::size_t position) const noexcept
+{
+    return m_owners[position];
+}
+
+auto schema::prefix(std::string_view key) const
+    -> std::pair<std::size_t, std::size_t>
+{
+    const auto first=lower(key);
+    auto end=first;
+    
+    for (auto last=m_owners.size(); end<last;) {
+        const auto middle=end+(last-end)/2;
+        
+        if (this->key(middle).substr(0, key.size())==key) {
+            end=middle+1;
+        } else {
+            last=middle;
+        }
+    }
+    
+    return {first, end};
+}
+
+argument& schema::object(std::size_t index) const
+{
+    return *m_objects.at(index);
+}
+
+auto schema::type(std::size_t index) const noexcept -> argument::category
+{
+    return static_cast<argument::category>(m_types[index]);
+}
+
+std::size_t schema::minimum(std::size_t index) const noexcept
+{
+    return unpack(m_minimum[index]);
+}
+
+std::size_t schema::maximum(std::size_t index) const noexcept
+{
+    return unpack(m_maximum[index]);
+}
+
+std::size_t schema::count(std::size_t index) const noexcept
+{
+    return unpack(m_counts[index]);
+}
+
+void schema::refresh()
+{
+    for (std::size_t index{0}; index<m_objects.size(); ++index) {
+        m_counts[index]=pack(m_objects[index]->count().value());
+    }
+}
+
+bool schema::describes(const range& scope) const
+{
+    const auto same=[](const argument& left, const argument* right) {
+        return (&left==right);
+    };
+    
+    if (!std::equal(scope.begin(), scope.end(), m_objects.begin(),
+        m_objects.end(), same)) {
+        return false;
+    }
+    
+    const auto& constraints=scope.constraints();
+    
+    return std::equal(constraints.begin(), constraints.end(),
+        m_constraints.begin(), m_constraints.end(),
+        [](const auto& left, const auto& right) {
+        return left.type==right.type && std::equal(left.objects.begin(),
+            left.objects.end(), right.objects.begin(), right.objects.end(),
+            [](const argument& first, const argument& second) {
+            return (&first==&second);
+        });
+    });
+}
+
+std::uint64_t schema::fingerprint() const noexcept
+{
+    return m_fingerprint;
+}
+
+void schema::enforce() const
+{
+    if (m_rules.empty()) {
+        return;
+    }
+    
+    std::vector<std::uint64_t> set((m_objects.size()+63)/64);
+    
+    for (std::size_t index{0}; index<m_objects.size(); ++index) {
+        if (m_objects[index]->set()) {
+            set[index/64]|=std::uint64_t{1}<<(index%64);
+        }
+    }
+    
+    const auto collect=[&](const rule& item, bool state) {
+        std::vector<std::string> result;
+        
+        for (auto word=item.first; word<item.last; ++word) {
+            const auto mask=m_masks[item.offset+word-item.first];
+            auto bits=state ? (mask&set[word]) : (mask&~set[word]);
+            
+            for (; bits; bits&=bits-1) {
+                const auto index=word*64+__builtin_ctzll(bits);
+                result.push_back(m_objects[index]->name());
+            }
+        }
+        
+        return result;
+    };
+    
+    for (const auto& item:m_rules) {
+        std::size_t present{0};
+        std::size_t absent{0};
+        
+        for (auto word=item.first; word<item.last; ++word) {
+            const auto mask=m_masks[item.offset+word-item.first];
+            
+            present+=population(mask&set[word]);
+            absent+=population(mask&~set[word]);
+        }
+        
+        if (item.type==range::relation::exclusion && present>1) {
+            throw excessive_group{collect(item, true)};
+        } else if (item.type==range::relation::inclusion && present==0) {
+            throw deficient_group{collect(item, false)};
+        } else if (item.type==range::relation::implication && absent>0 &&
+            m_objects[item.premise]->set()) {
+            throw unmet_implication{m_objects[item.premise]->name(),
+                collect(item, false)};
+        }
+    }
+}
+
+auto schema::measure() const -> footprint
+{
+    footprint result{size(), 0, 0};
+    
+    for (const argument* object:m_objects) {
+        const auto& name=object->name();
+        
+        result.legacy+=sizeof(std::reference_wrapper<argument>)+
+            sizeof(argument::quantifier)+heap(name.keys())+
+            heap(name.standard())+heap(name.current());
+        
+        for (const auto& key:name.keys()) {
+            result.legacy+=heap(key);
+        }
+        
+        if (object->type()==argument::category::command) {
+            result.legacy+=sizeof(command::qualifier);
+        } else if (object->type()==argument::category::option) {
+            const auto& qualifier=static_cast<const option*>(object)->name();
+            
+            result.legacy+=sizeof(option::qualifier)+
+                heap(qualifier.brief())+heap(qualifier.wide());
+        } else {
+            result.legacy+=sizeof(argument::qualifier);
+        }
+    }
+    
+    result.packed=sizeof(schema)+m_pool.capacity()+heap(m_offsets)+
+        heap(m_owners)+heap(m_objects)+heap(m_types)+heap(m_minimum)+
+        heap(m_maximum)+heap(m_counts)+heap(m_constraints)+heap(m_rules)+
+        heap(m_masks)+heap(m_nodes)+heap(m_labels)+heap(m_children);
+    
+    return result;
+}
+
+// first key after position not sharing its leading characters
+std::size_t schema::skip(std::size_t position,
+    std::size_t length) const noexcept
+{
+    const auto stem=key(position).substr(0, length);
+    
+    auto first=position+1;
+    auto last=first;
+    
+    for (std::size_t step{1}; last<keys() && key(last).substr(0, length)==stem;
+        step*=2) {
+        first=last+1;
+        last=position+step*2;
+    }
+    
+    last=std::min(last, keys());
+    
+    while (first<last) {
+        const auto middle=first+(last-first)/2;
+        
+        if (key(middle).substr(0, length)==stem) {
+            first=middle+1;
+        } else {
+            last=middle;
+        }
+    }
+    
+    return first;
+}
+
+void schema::compile(const range& scope)
+{
+    m_constraints=scope.constraints();
+    
+    if (m_constraints.empty()) {
+        return;
+    }
+    
+    std::unordered_map<const argument*, std::uint32_t> positions;
+    
+    for (std::size_t index{0}; index<m_objects.size(); ++index) {
+        positions.emplace(m_objects[index], pack(index));
+    }
+    
+    for (const auto& [type, objects]:scope.constraints()) {
+        std::vector<std::uint32_t> members;
+        
+        for (const argument& object:objects) {
+            const auto match=positions.find(&object);
+            
+            if (match==positions.end()) {
+                throw usage_error{"constraint outside of its range"};
+            }
+            
+            members.push_back(match->second);
+        }
+        
+        rule item{type, 0, pack(m_masks.size()), 0, 0};
+        
+        if (type==range::relation::implication && !members.empty()) {
+            item.premise=members.front();
+            members.erase(members.begin());
+        }
+        
+        if (members.empty()) {
+            continue;
+        }
+        
+        const auto [minimum, maximum]=std::minmax_element(members.begin(),
+            members.end());
+        
+        item.first=*minimum/64;
+        item.last=*maximum/64+1;
+        
+        m_masks.resize(m_masks.size()+item.last-item.first);
+        
+        for (const auto member:members) {
+            m_masks[item.offset+member/64-item.first]|=
+                std::uint64_t{1}<<(member%64);
+        }
+        
+        m_rules.push_back(item);
+    }
+}
+
+std::size_t schema::lower(std::string_view key) const noexcept
+{
+    std::size_t first{0};
+    std::size_t last{m_owners.size()};
+    
+    while (first<last) {
+        const auto middle=first+(last-first)/2;
+        
+        if (this->key(middle)<key) {
+            first=middle+1;
+        } else {
+            last=middle;
+        }
+    }
+    
+    return first;
+}
+
+// builds the trie node for sorted keys [first, last) sharing depth characters
+std::uint32_t schema::grow(std::size_t first, std::size_t last,
+    std::size_t depth)
+{
+    const auto current=pack(m_nodes.size());
+    m_nodes.push_back({0, 0, pack(first), m_owners[first]});
+    
+    for (auto position=first; position<last; ++position) {
+        if (m_owners[position]!=m_nodes[current].owner) {
+            m_nodes[current].owner=saturation;
+            break;
+        }
+    }
+    
+    std::vector<std::pair<char, std::pair<std::size_t, std::size_t>>> groups;
+    
+    for (auto position=first; position<last; ++position) {
+        if (const auto item=key(position); item.size()>depth) {
+            if (groups.empty() || groups.back().first!=item[depth]) {
+                groups.push_back({item[depth], {position, position}});
+            }
+            
+            groups.back().second.second=position+1;
+        }
+    }
+    
+    m_nodes[current].first=pack(m_labels.size());
+    m_nodes[current].last=pack(m_labels.size()+groups.size());
+    
+    for (const auto& group:groups) {
+        m_labels.push_back(group.first);
+        m_children.push_back(0);
+    }
+    
+    for (std::size_t index{0}; index<groups.size(); ++index) {
+        const auto [begin, end]=groups[index].second;
+        const auto child=grow(begin, end, depth+1);
+        
+        m_children[m_nodes[current].first+index]=child;
+    }
+    
+    return current;
+}
+
+}
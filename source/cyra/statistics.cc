@@ -0,0 +1,96 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cyra/exception.hh>
+#include <cyra/statistics.hh>
+
+#include <algorithm>
+#include <limits>
+
+namespace cyra {
+
+void statistics::dump(std::ostream& stream) const
+{
+    const auto microseconds=[](std::chrono::nanoseconds duration) {
+        return std::chrono::duration<double, std::micro>(duration).count();
+    };
+    
+    stream << "tokens " << tokens << '\n'
+        << "attempts " << attempts << '\n'
+        << "lookups " << lookups << '\n'
+        << "stores " << stores << '\n'
+        << "heap values " << heap_values << '\n'
+        << "exceptions " << exceptions << '\n'
+        << "lex " << microseconds(lex) << " us\n"
+        << "match " << microseconds(match) << " us\n"
+        << "store " << microseconds(store) << " us\n"
+        << "verify " << microseconds(verify) << " us\n"
+        << "arguments " << footprint.size << '\n'
+        << "legacy " << footprint.legacy << " bytes\n"
+        << "packed " << footprint.packed << " bytes\n";
+}
+
+trace::trace(std::size_t capacity)
+    : m_records(capacity)
+{
+    if (capacity==0) {
+        throw initialization_error{"trace without capacity"};
+    }
+}
+
+void trace::push(event type, std::size_t token) noexcept
+{
+    m_records[m_next]={type, static_cast<std::uint32_t>(std::min<std::size_t>(
+        token, std::numeric_limits<std::uint32_t>::max()))};
+    
+    m_next=(m_next+1)%m_records.size();
+    m_size=std::min(m_size+1, m_records.size());
+}
+
+void trace::clear() noexcept
+{
+    m_next=0;
+    m_size=0;
+}
+
+auto trace::records() const -> std::vector<record>
+{
+    std::vector<record> result;
+    result.reserve(m_size);
+    
+    const auto first=(m_next+m_records.size()-m_size)%m_records.size();
+    
+    for (std::size_t index{0}; index<m_size; ++index) {
+        result.push_back(m_records[(first+index)%m_records.size()]);
+    }
+    
+    return result;
+}
+
+void trace::dump(std::ostream& stream) const
+{
+    static constexpr const char* names[]{
+        "token", "command", "option", "value", "operand", "verify", "error"
+    };
+    
+    for (const auto& item:records()) {
+        stream << names[static_cast<std::size_t>(item.type)]
+            << ' ' << item.token << '\n';
+    }
+}
+
+}
@@ -0,0 +1,289 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cyra/unit.hh>
+
+#include <limits>
+#include <numeric>
+
+namespace cyra {
+
+namespace {
+
+using outcome=cast_result::outcome;
+
+struct unit {
+    std::string_view suffix;
+    std::uint64_t numerator, denominator;
+};
+
+constexpr unit times[]{
+    {"ns", 1, 1000000000}, {"us", 1, 1000000}, {"\xc2\xb5s", 1, 1000000},
+    {"ms", 1, 1000}, {"s", 1, 1}, {"m", 60, 1}, {"min", 60, 1},
+    {"h", 3600, 1}, {"d", 86400, 1}
+};
+
+std::uint64_t prefix(std::string_view name) // k, K, M, ..., E, Ki, ..., Ei
+{
+    constexpr std::uint64_t powers[]{1, 1000, 1000000, 1000000000,
+        1000000000000, 1000000000000000, 1000000000000000000};
+    
+    constexpr std::string_view letters{"KMGTPE"};
+    
+    if (name.empty() || name.size()>2) {
+        return 0;
+    }
+    
+    const auto position=name[0]=='k' ? 0 : letters.find(name[0]);
+    
+    if (position==letters.npos || (name.size()==2 &&
+        (name[1]!='i' || name[0]=='k'))) {
+        return 0;
+    }
+    
+    return name.size()==1 ? powers[position+1] :
+        std::uint64_t{1}<<10*(position+1);
+}
+
+unit lookup(dimension type, std::string_view name) // zero if unknown
+{
+    if (type==dimension::time) {
+        for (auto& entry:times) {
+            if (entry.suffix==name) {
+                return entry;
+            }
+        }
+    } else if (type==dimension::count) {
+        return {name, prefix(name), 1};
+    } else if (name=="B") {
+        return {name, 1, 1};
+    } else if (!name.empty() && name.back()=='B') {
+        return {name, prefix(name.substr(0, name.size()-1)), 1};
+    }
+    
+    return {name, 0, 1};
+}
+
+bool multiply(std::uint64_t& value, std::uint64_t factor)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_mul_overflow(value, factor, &value);
+#else
+    if (factor!=0 && value>std::numeric_limits<std::uint64_t>::max()/factor) {
+        return false;
+    }
+    
+    value*=factor;
+    
+    return true;
+#endif
+}
+
+struct fraction {
+    std::uint64_t numerator, denominator;
+    
+    // multiply by numerator/denominator, reducing crosswise first so that
+    // the result only overflows when it really is that large or that fine
+    
+    outcome scale(std::uint64_t numerator, std::uint64_t denominator)
+    {
+        if (this->denominator==1 && denominator==1) { // the common case
+            return multiply(this->numerator, numerator) ? outcome::success :
+                outcome::overflow;
+        }
+        
+        const auto upper=std::gcd(this->numerator, denominator);
+        const auto lower=std::gcd(numerator, this->denominator);
+        
+        this->numerator/=upper;
+        this->denominator/=lower;
+        
+        if (!multiply(this->numerator, numerator/lower)) {
+            return outcome::overflow;
+        }
+        
+        if (!multiply(this->denominator, denominator/upper)) {
+            return outcome::invalid; // not a whole number of units
+        }
+        
+        return outcome::success;
+    }
+};
+
+bool digit(char character)
+{
+    return static_cast<unsigned char>(character-'0')<=9;
+}
+
+bool append(std::uint64_t& value, char character)
+{
+    constexpr auto limit=std::numeric_limits<std::uint64_t>::max()/10;
+    
+    const unsigned addend=character-'0';
+    
+    return value<=limit && (value=value*10+addend)>=addend;
+}
+
+outcome parse(std::string_view value, dimension type,
+    std::uint64_t numerator, std::uint64_t denominator,
+    std::uint64_t& result, bool& negative)
+{
+    auto first=value.data(), last=value.data()+value.size();
+    
+    while (first!=last && *first==' ') {
+        ++first;
+    }
+    
+    if (first!=last && (*first=='+' || *first=='-')) {
+        negative=*first++=='-';
+    }
+    
+    std::uint64_t total{0}; // kept local, stores to result could alias value
+    
+    do {
+        fraction part{0, 1};
+        bool empty{true};
+        
+        for (; first!=last && digit(*first); ++first, empty=false) {
+            if (!append(part.numerator, *first)) {
+                return outcome::overflow;
+            }
+        }
+        
+        if (first!=last && *first=='.') {
+            for (++first; first!=last && digit(*first); ++first, empty=false) {
+                if (!append(part.numerator, *first) ||
+                    !multiply(part.denominator, 10)) {
+                    return outcome::overflow;
+                }
+            }
+        }
+        
+        if (empty) {
+            return outcome::invalid;
+        }
+        
+        while (first!=last && *first==' ') {
+            ++first;
+        }
+        
+        auto suffix=first;
+        
+        while (first!=last && !digit(*first) && *first!='.' && *first!=' ') {
+            ++first;
+        }
+        
+        const std::string_view name(suffix, first-suffix);
+        
+        if (name.empty() && total!=0) {
+            return outcome::invalid; // 1h30 is ambiguous
+        }
+        
+        if (!name.empty()) {
+            const auto entry=lookup(type, name);
+            
+            if (entry.numerator==0) {
+                return outcome::invalid;
+            }
+            
+            if (auto status=part.scale(entry.numerator, entry.denominator);
+                status!=outcome::success) {
+                return status;
+            }
+            
+            if (auto status=numerator==denominator ? outcome::success :
+                part.scale(denominator, numerator); status!=outcome::success) {
+                return status;
+            }
+        }
+        
+        if (part.denominator!=1 && part.numerator%part.denominator!=0) {
+            return outcome::invalid; // not a whole number of units
+        }
+        
+        const auto whole=part.denominator==1 ? part.numerator :
+            part.numerator/part.denominator;
+        
+        if ((total+=whole)<whole) {
+            return outcome::overflow;
+        }
+        
+        while (first!=last && *first==' ') {
+            ++first;
+        }
+        
+        if (name.empty() || type!=dimension::time) {
+            break;
+        }
+    } while (first!=last);
+    
+    result=total;
+    
+    return first==last ? outcome::success : outcome::invalid;
+}
+
+}
+
+cast_result measure(std::string_view value, dimension type,
+    std::uint64_t numerator, std::uint64_t denominator,
+    std::uint64_t& result, bool& negative)
+{
+    const char* description{type==dimension::size ? "a byte size" :
+        type==dimension::count ? "a quantity" : "a duration"};
+    
+    negative=false;
+    
+    if (auto status=parse(value, type, numerator, denominator, result,
+        negative); status!=outcome::success) {
+        return {status==outcome::overflow && negative ? outcome::underflow :
+            status, description};
+    }
+    
+    negative=negative && result!=0;
+    
+    return {outcome::success, description};
+}
+
+namespace {
+
+cast_result count(std::string_view value, dimension type,
+    std::uint64_t& result)
+{
+    bool negative{false};
+    
+    if (auto status=measure(value, type, 1, 1, result, negative); !status) {
+        return status;
+    } else if (negative) {
+        return {outcome::underflow, status.type};
+    } else {
+        return status;
+    }
+}
+
+}
+
+cast_result convert(std::string_view value, capacity& result)
+{
+    return count(value, dimension::size, result.bytes);
+}
+
+cast_result convert(std::string_view value, quantity& result)
+{
+    return count(value, dimension::count, result.count);
+}
+
+}
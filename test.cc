@@ -0,0 +1,697 @@
+/*  Cyra - A C++ command line parsing library
+    Copyright (C) 2018 North Crescent
+    
+    This program is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+    
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+    more details.
+    
+    You should have received a copy of the GNU General Public License along with
+    this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cyra/argument.hh>
+#include <cyra/batch.hh>
+#include <cyra/binary.hh>
+#include <cyra/cache.hh>
+#include <cyra/cast.hh>
+#include <cyra/choice.hh>
+#include <cyra/commandline.hh>
+#include <cyra/completion.hh>
+#include <cyra/configuration.hh>
+#include <cyra/container.hh>
+#include <cyra/environment.hh>
+#include <cyra/exception.hh>
+#include <cyra/lexer.hh>
+#include <cyra/parser.hh>
+#include <cyra/pool.hh>
+#include <cyra/schema.hh>
+#include <cyra/statistics.hh>
+#include <cyra/unit.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cyra;
+
+namespace {
+
+int failures{0};
+
+void check(bool condition, const char* description, int line)
+{
+    if (!condition) {
+        std::printf("line %d: %s\n", line, description);
+        ++failures;
+    }
+}
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+template<typename Error, typename Function>
+bool raises(Function&& function)
+{
+    try {
+        function();
+    } catch (const Error&) {
+        return true;
+    } catch (...) {
+        return false;
+    }
+    
+    return false;
+}
+
+commandline line(std::vector<std::string> arguments)
+{
+    arguments.insert(arguments.begin(), "test");
+    return commandline{arguments};
+}
+
+std::size_t levenshtein(const std::string& a, const std::string& b)
+{
+    std::vector<std::size_t> row(b.size()+1);
+    
+    for (std::size_t column{0}; column<=b.size(); ++column) {
+        row[column]=column;
+    }
+    
+    for (std::size_t index{1}; index<=a.size(); ++index) {
+        auto diagonal=row[0];
+        row[0]=index;
+        
+        for (std::size_t column{1}; column<=b.size(); ++column) {
+            const auto above=row[column];
+            
+            row[column]=std::min({row[column]+1, row[column-1]+1,
+                diagonal+(a[index-1]!=b[column-1])});
+            diagonal=above;
+        }
+    }
+    
+    return row[b.size()];
+}
+
+enum class level {
+    fast, safe, paranoid
+};
+
+}
+
+namespace cyra {
+
+template<>
+struct choices<level> {
+    static constexpr auto table=spell<level>({{"fast", level::fast},
+        {"safe", level::safe}, {"paranoid", level::paranoid}});
+};
+
+}
+
+namespace {
+
+void lazy_lists()
+{
+    operand<lazy<int>> numbers{0, 2};
+    auto terminal=line({"1", "x"});
+    
+    attach(terminal, numbers);
+    parse<gnu>(terminal);
+    
+    CHECK(numbers.size()==2);
+    CHECK(numbers[0]==1);
+    CHECK(raises<cast_error>([&] { numbers.validate(); }));
+    
+    list<lazy<int>> shared;
+    
+    for (int index{0}; index<1000; ++index) {
+        shared.append(std::to_string(index));
+    }
+    
+    std::atomic<std::size_t> sum{0};
+    pool workers{4};
+    
+    workers.run(4000, [&](std::size_t index, std::size_t) {
+        sum+=static_cast<std::size_t>(shared[index%1000]);
+    });
+    
+    CHECK(sum==4*499500);
+}
+
+void abbreviations()
+{
+    flag verbose{"--verbose"}, version{"--version"}, quiet{"--quiet"};
+    auto terminal=line({"--qu", "--verb"});
+    
+    attach(terminal, verbose, version, quiet);
+    
+    gnu style;
+    parser core{style};
+    core.abbreviate(true);
+    core(terminal);
+    
+    CHECK(quiet.set() && verbose.set() && !version.set());
+    
+    auto ambiguous=line({"--ver"});
+    attach(ambiguous, verbose, version, quiet);
+    reset(ambiguous);
+    
+    CHECK(raises<ambiguous_argument>([&] { core(ambiguous); }));
+}
+
+void suggestions()
+{
+    std::mt19937 random{42};
+    std::uniform_int_distribution<int> letter{'a', 'e'}, size{1, 9};
+    
+    for (int round{0}; round<200; ++round) {
+        std::vector<std::string> keys;
+        std::deque<flag> flags; // stable, arguments do not move
+        
+        while (keys.size()<16) {
+            std::string key{"--"};
+            
+            for (auto count=size(random); count>0; --count) {
+                key+=static_cast<char>(letter(random));
+            }
+            
+            if (std::find(keys.begin(), keys.end(), key)==keys.end()) {
+                keys.push_back(key);
+                flags.emplace_back(key);
+            }
+        }
+        
+        range scope;
+        
+        for (auto& item:flags) {
+            scope.attach(item);
+        }
+        
+        std::string query{"--"};
+        
+        for (auto count=size(random); count>0; --count) {
+            query+=static_cast<char>(letter(random));
+        }
+        
+        const auto result=scope.index().suggest(query, 1);
+        
+        auto best=levenshtein(query, keys[0]);
+        
+        for (auto& key:keys) {
+            best=std::min(best, levenshtein(query, key));
+        }
+        
+        const auto limit=(query.size()<=4) ? 1u :
+            (query.size()<=8) ? 2u : 3u;
+        
+        if (best<=limit) {
+            CHECK(result.size()==1 && levenshtein(query, result[0])==best);
+        } else {
+            CHECK(result.empty());
+        }
+    }
+}
+
+void completions()
+{
+    flag verbose{"--verbose"}, version{"--version"};
+    value<int> jobs{{"--jobs"}, 1, 1};
+    command remote{"remote"};
+    
+    range root;
+    attach(root, verbose, version, jobs, remote);
+    
+    const completion complete{root};
+    
+    const auto keys=complete({"--ve"}).keys;
+    CHECK((keys==std::vector<std::string>{"--verbose", "--version"}));
+    
+    CHECK(complete({"--jobs", ""}).type==completion::category::value);
+}
+
+void statistics_and_trace()
+{
+    flag verbose{"-v"};
+    auto terminal=line({"-v", "-x"});
+    attach(terminal, verbose);
+    
+    statistics counts;
+    trace log;
+    
+    gnu style;
+    parser core{style};
+    core.measure(&counts);
+    core.record(&log);
+    
+    CHECK(raises<invalid_argument>([&] { core(terminal); }));
+    CHECK(counts.tokens==2 && counts.exceptions==1);
+    CHECK(counts.stores==0 && counts.heap_values==0);
+    CHECK(!log.records().empty() &&
+        log.records().back().type==trace::event::error &&
+        log.records().back().token==2);
+}
+
+void constraints()
+{
+    flag a{"-a"}, b{"-b"}, c{"-c"};
+    
+    auto both=line({"-a", "-b"});
+    attach(both, a, b, c);
+    exclude(both, a, b);
+    
+    CHECK(raises<excessive_group>([&] { parse<gnu>(both); }));
+    
+    reset(both);
+    
+    auto implied=line({"-a"});
+    attach(implied, a, b, c);
+    imply(implied, a, c);
+    
+    CHECK(raises<unmet_implication>([&] { parse<gnu>(implied); }));
+    
+    range detached;
+    attach(detached, a);
+    
+    CHECK(raises<usage_error>([&] { exclude(detached, a, b); }));
+}
+
+void delimited_casts()
+{
+    std::vector<int> integers;
+    cast("1,-2,30", ',', integers);
+    
+    CHECK((integers==std::vector<int>{1, -2, 30}));
+    CHECK(raises<cast_error>([&] { cast("1,x", ',', integers); }));
+    
+    std::vector<double> reals;
+    cast("0.5,2e3", ',', reals);
+    
+    CHECK((reals==std::vector<double>{0.5, 2000}));
+}
+
+void units_and_choices()
+{
+    CHECK(cast<capacity>("512MiB").bytes==512u<<20);
+    CHECK(cast<capacity>("1.5GB").bytes==1500000000u);
+    CHECK(cast<quantity>("64Ki").count==65536u);
+    CHECK(cast<std::chrono::seconds>("1h30m").count()==5400);
+    CHECK(raises<cast_error>([] { cast<capacity>("12XB"); }));
+    
+    CHECK(cast<level>("safe")==level::safe);
+    CHECK(raises<cast_error>([] { cast<level>("slow"); }));
+}
+
+void binary_values()
+{
+    const auto bytes=cast<std::vector<std::byte>>("0x00ff10");
+    
+    CHECK(bytes.size()==3 && bytes[1]==std::byte{0xff});
+    CHECK(cast<std::vector<std::byte>>("@b64:AP8Q")==bytes);
+    CHECK(raises<cast_error>([] { cast<std::vector<std::byte>>("abc"); }));
+}
+
+void containers()
+{
+    value<mapping<std::string, int>> defines{{"-D"}, 0, 8};
+    value<pooled> names{{"-n"}, 0, 8};
+    value<interned> tags{{"-t"}, 0, 8};
+    
+    auto terminal=line({"-Da=1", "-Db=2", "-Da=3", "-nx", "-ny",
+        "-tq", "-tq"});
+    attach(terminal, defines, names, tags);
+    parse<gnu>(terminal);
+    
+    CHECK(defines.size()==2 && defines.at("a")==3);
+    CHECK(names.size()==2 && names[1]=="y");
+    CHECK(tags.size()==2 && tags.distinct()==1);
+}
+
+void fallbacks()
+{
+    value<int> jobs{"-j"};
+    jobs.fallback(4);
+    
+    auto terminal=line({});
+    attach(terminal, jobs);
+    parse<gnu>(terminal);
+    
+    CHECK(jobs.get()==4 && jobs.defaulted());
+    CHECK(jobs.provenance()==argument::origin::fallback);
+    
+    value<bool> color{"-c"};
+    value<lazy<int>> depth{"-d"};
+    value<delimited<int>> sizes{"-s"};
+    value<pooled> name{"-n"};
+    
+    depth.fallback(2);
+    name.fallback("none");
+    
+    auto given=line({"-cyes", "-s1,2,3"});
+    attach(given, color, depth, sizes, name);
+    parse<gnu>(given);
+    
+    CHECK(color.get());
+    CHECK(depth.get()==2);
+    CHECK(sizes.get()==3);
+    CHECK(name.get()=="none");
+}
+
+void environment_and_configuration()
+{
+    value<int> jobs{"--jobs"};
+    value<std::string> name{"--name"};
+    flag verbose{"--verbose"};
+    
+    jobs.bind("JOBS");
+    
+    const char* entries[]{"JOBS=8", nullptr};
+    const environment variables{entries};
+    
+    const configuration file{"name = \"x\"\nverbose\njobs = 2\n", "app.conf"};
+    
+    auto terminal=line({});
+    attach(terminal, jobs, name, verbose);
+    
+    gnu style;
+    parser core{style};
+    core.snapshot(&variables);
+    core.configure(&file);
+    core(terminal);
+    
+    CHECK(jobs.get()==8);
+    CHECK(jobs.provenance()==argument::origin::environment);
+    CHECK(name.get()=="x");
+    CHECK(name.provenance()==argument::origin::configuration);
+    CHECK(verbose.provenance()==argument::origin::configuration);
+    
+    const configuration broken{"jobs = many\n", "app.conf"};
+    core.snapshot(nullptr);
+    core.configure(&broken);
+    
+    auto again=line({});
+    attach(again, jobs, name, verbose);
+    reset(again);
+    
+    bool reported{false};
+    
+    try {
+        core(again);
+    } catch (const configuration_error& error) {
+        reported=error.line()==1 && error.path()=="app.conf";
+    }
+    
+    CHECK(reported);
+}
+
+void splitting()
+{
+    const commandline quoted{"app -a 'b c' \"d\\\"e\"", shell{}};
+    operand<std::string> values{0, 3};
+    flag a{"-a"};
+    
+    auto terminal=quoted;
+    attach(terminal, a, values);
+    parse<gnu>(terminal);
+    
+    CHECK(values.count()==2 && values[0]=="b c" && values[1]=="d\"e");
+    CHECK(raises<unterminated_quote>([] {
+        commandline{"app 'open", shell{}};
+    }));
+    
+    const commandline buffer{std::string{"app\0x\0y\0", 8}, separated{}};
+    CHECK(buffer.path()=="app");
+}
+
+void restrictions()
+{
+    flag a{"-a"};
+    auto terminal=line({"-aaaa"});
+    attach(terminal, a);
+    
+    gnu style;
+    parser core{style};
+    
+    limits bounds;
+    bounds.cluster=2;
+    core.restrict(bounds);
+    
+    CHECK(raises<limit_exceeded>([&] { core(terminal); }));
+    
+    bounds=limits{};
+    bounds.length=3;
+    core.restrict(bounds);
+    
+    auto other=line({"-aaaa"});
+    attach(other, a);
+    reset(other);
+    
+    CHECK(raises<limit_exceeded>([&] { core(other); }));
+    
+    // a cluster is walked in place, quadratic time would take hours here
+    
+    flag many{{"-m"}, 0, limits::unbounded};
+    auto cluster=line({"-"+std::string(1<<20, 'm')});
+    attach(cluster, many);
+    
+    const auto start=std::chrono::steady_clock::now();
+    core.restrict(limits{});
+    core(cluster);
+    
+    CHECK(many.count()==1<<20);
+    CHECK(std::chrono::steady_clock::now()-start<std::chrono::seconds{10});
+}
+
+void reuse()
+{
+    value<int> jobs{{"-j"}, 1, 1};
+    flag verbose{"-v"}, all{"-a"};
+    
+    gnu style;
+    parser core{style};
+    
+    auto failing=line({"-v", "-j"});
+    attach(failing, jobs, verbose, all);
+    
+    CHECK(raises<deficient_count>([&] { core(failing); }));
+    
+    auto valid=line({"-a", "-j2"});
+    attach(valid, jobs, verbose, all);
+    reset(valid);
+    core(valid);
+    
+    CHECK(all.set() && !verbose.set() && jobs.get()==2);
+    
+    auto cluster=line({"-vax"});
+    attach(cluster, jobs, verbose, all);
+    reset(cluster);
+    
+    CHECK(raises<invalid_argument>([&] { core(cluster); }));
+    
+    auto after=line({"-j3"});
+    attach(after, jobs, verbose, all);
+    reset(after);
+    core(after);
+    
+    CHECK(!all.set() && !verbose.set() && jobs.get()==3);
+}
+
+void caching()
+{
+    value<int> jobs{"-j"};
+    flag verbose{"-v"};
+    
+    gnu style;
+    parser core{style};
+    
+    cache results{8};
+    core.memoize(&results);
+    
+    for (int round{0}; round<3; ++round) {
+        auto terminal=line({"-j3", "-v"});
+        attach(terminal, jobs, verbose);
+        core(terminal);
+        
+        CHECK(jobs.count()==1 && jobs.get()==3 && verbose.count()==1);
+    }
+    
+    CHECK(results.misses()==1 && results.hits()==2);
+    
+    auto other=line({"-j5"});
+    attach(other, jobs, verbose);
+    core(other);
+    
+    CHECK(results.misses()==2 && jobs.get()==5 && !verbose.set());
+    
+    // nested commands are only checked, and populated, once entered
+    
+    command remote{"remote"}, local{"local"};
+    flag force{"-f"};
+    int built{0};
+    
+    remote.defer([&](command& scope) {
+        ++built;
+        scope.emplace<flag>("-f");
+    });
+    
+    attach(local, force);
+    
+    for (int round{0}; round<2; ++round) {
+        auto terminal=line({"-j2"});
+        attach(terminal, jobs, remote, local);
+        core(terminal);
+    }
+    
+    CHECK(built==0 && results.hits()==3);
+    
+    auto entered=line({"local", "-f"});
+    attach(entered, jobs, remote, local);
+    core(entered);
+    
+    flag extra{"-x"};
+    attach(local, extra); // same line, another schema below the root
+    
+    auto changed=line({"local", "-f"});
+    attach(changed, jobs, remote, local);
+    core(changed);
+    
+    CHECK(results.hits()==3 && local.set() && force.set());
+}
+
+void pipelines()
+{
+    value<int> a{{"--alpha"}, 0, 8}, b{{"--beta"}, 0, 8};
+    
+    pool workers{2};
+    gnu style;
+    parser core{style};
+    core.pipeline(&workers);
+    
+    auto terminal=line({"--alpha=1", "--beta=2", "--alpha=3"});
+    attach(terminal, a, b);
+    core(terminal);
+    
+    CHECK(a.count()==2 && a[1]==3 && b.get()==2);
+    
+    // the first value to fail in input order, whatever the tray order
+    
+    for (auto target:{&workers, static_cast<pool*>(nullptr)}) {
+        core.pipeline(target);
+        
+        auto bad=line({"--alpha=1", "--beta=x", "--alpha=y"});
+        attach(bad, a, b);
+        reset(bad);
+        
+        bool reported{false};
+        
+        try {
+            core(bad);
+        } catch (const invalid_element& error) {
+            reported=error.argument()=="option --beta" && error.token()==2 &&
+                error.index()==0;
+        }
+        
+        CHECK(reported);
+    }
+}
+
+struct job {
+    value<int> level{{"-l", "--level"}, 1, 1};
+    
+    int operator()(commandline& line)
+    {
+        attach(line, level);
+        parse<gnu>(line);
+        
+        return level.get();
+    }
+};
+
+void batches()
+{
+    std::vector<std::vector<std::string>> inputs;
+    
+    for (int index{0}; index<64; ++index) {
+        inputs.push_back({"test", "-l", std::to_string(index)});
+    }
+    
+    inputs.push_back({"test", "-l", "x"});
+    
+    pool workers{2};
+    const auto results=batch<job>(workers, inputs.begin(), inputs.end());
+    
+    CHECK(results.size()==65);
+    CHECK(results[10].value()==10 && results[63].value()==63);
+    CHECK(!results[64].good());
+    
+    struct check_only {
+        job inner;
+        
+        void operator()(commandline& line)
+        {
+            inner(line);
+        }
+    };
+    
+    const auto checked=batch<check_only>(workers, inputs.begin(),
+        inputs.end());
+    
+    CHECK(checked[0].good() && !checked[64].good());
+    CHECK(raises<invalid_element>([&] { checked[64].value(); }));
+}
+
+void deferred_commands()
+{
+    command remote{"remote"};
+    int built{0};
+    
+    remote.defer([&](command& scope) {
+        ++built;
+        scope.emplace<flag>("-f");
+    });
+    
+    auto terminal=line({"remote", "-f"});
+    attach(terminal, remote);
+    parse<gnu>(terminal);
+    
+    CHECK(built==1 && remote.set());
+}
+
+}
+
+int main()
+{
+    lazy_lists();
+    abbreviations();
+    suggestions();
+    completions();
+    statistics_and_trace();
+    constraints();
+    delimited_casts();
+    units_and_choices();
+    binary_values();
+    containers();
+    fallbacks();
+    environment_and_configuration();
+    splitting();
+    restrictions();
+    reuse();
+    caching();
+    pipelines();
+    batches();
+    deferred_commands();
+    
+    std::printf("%d failures\n", failures);
+    
+    return failures ? 1 : 0;
+}